@@ -0,0 +1,52 @@
+#include "alignedallocator.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+
+std::atomic<bool> hugePagesEnabled{false}; ///< Whether large allocations are advised to be backed by huge pages.
+
+std::size_t getAlignment(const std::size_t size)
+{
+    return size >= geometrize::HUGE_PAGE_SIZE ? geometrize::HUGE_PAGE_SIZE : geometrize::BITMAP_ALIGNMENT;
+}
+
+}
+
+namespace geometrize
+{
+
+void* allocateAligned(const std::size_t size)
+{
+    const std::size_t alignment{getAlignment(size)};
+    void* const memory{::operator new(size, std::align_val_t{alignment})};
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if(alignment == HUGE_PAGE_SIZE && hugePagesEnabled) {
+        // Only whole huge pages can be backed by huge pages. This is advice, so failure is harmless and ignored
+        const std::size_t length{size - size % HUGE_PAGE_SIZE};
+        static_cast<void>(madvise(memory, length, MADV_HUGEPAGE));
+    }
+#endif
+
+    return memory;
+}
+
+void deallocateAligned(void* const memory, const std::size_t size)
+{
+    ::operator delete(memory, std::align_val_t{getAlignment(size)});
+}
+
+void setHugePagesEnabled(const bool enabled)
+{
+    hugePagesEnabled = enabled;
+}
+
+}
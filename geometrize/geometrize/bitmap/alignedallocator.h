@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace geometrize
+{
+
+/// The alignment of bitmap data, and of the start of each row of it. This is the width of the widest vector registers (AVX-512), and the size of a cache line.
+constexpr std::size_t BITMAP_ALIGNMENT{64U};
+
+/// The size of a huge page. Allocations at least this large are aligned to it, so that they can be backed by huge pages.
+constexpr std::size_t HUGE_PAGE_SIZE{2U * 1024U * 1024U};
+
+/**
+ * @brief allocateAligned Allocates memory aligned to BITMAP_ALIGNMENT, or to HUGE_PAGE_SIZE for allocations of at least that size.
+ * Large allocations are advised to be backed by huge pages if huge pages are enabled and the platform supports them.
+ * @param size The size of the allocation in bytes.
+ * @return The memory allocated.
+ */
+void* allocateAligned(std::size_t size);
+
+/**
+ * @brief deallocateAligned Frees memory allocated with allocateAligned.
+ * @param memory The memory to free.
+ * @param size The size of the allocation in bytes, as passed to allocateAligned.
+ */
+void deallocateAligned(void* memory, std::size_t size);
+
+/**
+ * @brief setHugePagesEnabled Sets whether large allocations made by allocateAligned are advised to be backed by huge pages (madvise MADV_HUGEPAGE).
+ * Huge pages cut TLB misses when working on large images. Disabled by default, and has no effect on platforms without transparent huge pages.
+ * @param enabled True to advise huge pages for allocations made from now on, false not to.
+ */
+void setHugePagesEnabled(bool enabled);
+
+/**
+ * @brief The AlignedAllocator class is an allocator that hands out memory aligned with allocateAligned, for use with standard containers.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+template<typename T> class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template<typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(const std::size_t n)
+    {
+        return static_cast<T*>(geometrize::allocateAligned(n * sizeof(T)));
+    }
+
+    void deallocate(T* const p, const std::size_t n)
+    {
+        geometrize::deallocateAligned(p, n * sizeof(T));
+    }
+};
+
+template<typename T, typename U> bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U> bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+{
+    return false;
+}
+
+}
@@ -1,20 +1,105 @@
 #include "bitmap.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "bitmapview.h"
+#include "mappedfile.h"
 #include "rgba.h"
 
+namespace
+{
+
+/**
+ * @brief getPaddedStride Gets the distance in bytes between the rows of owned bitmap data, rounded up so that every row starts on an aligned address.
+ */
+std::size_t getPaddedStride(const std::uint32_t width)
+{
+    const std::size_t rowSize{static_cast<std::size_t>(width) * 4U};
+    return (rowSize + geometrize::BITMAP_ALIGNMENT - 1U) / geometrize::BITMAP_ALIGNMENT * geometrize::BITMAP_ALIGNMENT;
+}
+
+}
+
 namespace geometrize
 {
 
-Bitmap::Bitmap(const std::uint32_t width, const std::uint32_t height, const geometrize::rgba color) : m_width{width}, m_height{height}, m_data(width * height * 4U)
+Bitmap::Bitmap(const std::uint32_t width, const std::uint32_t height, const geometrize::rgba color) :
+    m_width{width}, m_height{height}, m_data(getPaddedStride(width) * height), m_pixels{m_data.data()}, m_writablePixels{m_data.data()}, m_stride{getPaddedStride(width)}, m_borrowed{false}, m_file{}
 {
     fill(color);
 }
 
-Bitmap::Bitmap(const std::uint32_t width, const std::uint32_t height, const std::vector<std::uint8_t>& data) : m_width{width}, m_height{height}, m_data{data}
+Bitmap::Bitmap(const std::uint32_t width, const std::uint32_t height, const std::vector<std::uint8_t>& data) :
+    m_width{width}, m_height{height}, m_data(getPaddedStride(width) * height), m_pixels{m_data.data()}, m_writablePixels{m_data.data()}, m_stride{getPaddedStride(width)}, m_borrowed{false}, m_file{}
+{
+    const std::size_t rowSize{static_cast<std::size_t>(width) * 4U};
+    assert(rowSize * height == data.size());
+
+    for(std::size_t y = 0; y < height; y++) {
+        std::copy(data.begin() + static_cast<std::ptrdiff_t>(y * rowSize), data.begin() + static_cast<std::ptrdiff_t>((y + 1U) * rowSize), m_data.begin() + static_cast<std::ptrdiff_t>(y * m_stride));
+    }
+}
+
+Bitmap::Bitmap(const geometrize::BitmapView& view) :
+    m_width{view.getWidth()}, m_height{view.getHeight()}, m_data{}, m_pixels{view.getData()}, m_writablePixels{nullptr}, m_stride{view.getStride()}, m_borrowed{true}, m_file{}
 {
-    assert((width * height * 4U) == data.size());
+}
+
+Bitmap::Bitmap(std::shared_ptr<geometrize::MappedFile> file, const std::uint32_t width, const std::uint32_t height) :
+    m_width{width}, m_height{height}, m_data{}, m_pixels{file->getData()}, m_writablePixels{file->getWritableData()}, m_stride{static_cast<std::size_t>(width) * 4U}, m_borrowed{false}, m_file{std::move(file)}
+{
+    if(m_file->getSize() < m_stride * height) {
+        throw std::invalid_argument("Mapped file is too small for a " + std::to_string(width) + "x" + std::to_string(height) + " bitmap");
+    }
+}
+
+Bitmap& Bitmap::operator=(const geometrize::Bitmap& other)
+{
+    if(this == &other) {
+        return *this;
+    }
+
+    // Assigning to a writable mapped bitmap of the same size writes the pixels to the file, so the bitmap stays mapped
+    if(m_file && m_writablePixels && m_width == other.m_width && m_height == other.m_height) {
+        m_packedData = nullptr;
+        for(std::size_t y = 0; y < m_height; y++) {
+            std::copy(other.m_pixels + y * other.m_stride, other.m_pixels + y * other.m_stride + static_cast<std::size_t>(m_width) * 4U, m_writablePixels + y * m_stride);
+        }
+        return *this;
+    }
+
+    *this = geometrize::Bitmap(other);
+    return *this;
+}
+
+Bitmap::Bitmap(const geometrize::Bitmap& other) :
+    m_width{other.m_width}, m_height{other.m_height}, m_data{other.m_data}, m_pixels{other.m_pixels}, m_writablePixels{nullptr}, m_stride{other.m_stride}, m_borrowed{other.m_borrowed}, m_file{other.m_file}
+{
+    if(!m_borrowed && !m_file) {
+        m_pixels = m_data.data();
+        m_writablePixels = m_data.data();
+        return;
+    }
+
+    // Copies of a writable mapped bitmap are independent of it, so they are made in memory
+    if(m_file && m_file->isWritable()) {
+        m_file = nullptr;
+        m_stride = getPaddedStride(m_width);
+        m_data.resize(m_stride * m_height);
+        for(std::size_t y = 0; y < m_height; y++) {
+            std::copy(other.m_pixels + y * other.m_stride, other.m_pixels + y * other.m_stride + static_cast<std::size_t>(m_width) * 4U, m_data.begin() + static_cast<std::ptrdiff_t>(y * m_stride));
+        }
+        m_pixels = m_data.data();
+        m_writablePixels = m_data.data();
+    }
 }
 
 std::uint32_t Bitmap::getWidth() const
@@ -27,38 +112,66 @@ std::uint32_t Bitmap::getHeight() const
     return m_height;
 }
 
-std::vector<std::uint8_t> Bitmap::copyData() const
+std::size_t Bitmap::getStride() const
 {
-    return m_data;
+    return m_stride;
 }
 
-const std::vector<std::uint8_t>& Bitmap::getDataRef() const
+const std::uint8_t* Bitmap::getData() const
+{
+    return m_pixels;
+}
+
+geometrize::BitmapView Bitmap::getView() const
 {
-    return m_data;
+    return geometrize::BitmapView(m_pixels, m_width, m_height, m_stride);
 }
 
-geometrize::rgba Bitmap::getPixel(const std::uint32_t x, const std::uint32_t y) const
+bool Bitmap::isBorrowed() const
 {
-    const std::size_t index{(m_width * y + x) * 4U};
-    return geometrize::rgba{m_data[index], m_data[index + 1U], m_data[index + 2U], m_data[index + 3U]};
+    return m_borrowed;
 }
 
-void Bitmap::setPixel(const std::uint32_t x, const std::uint32_t y, const geometrize::rgba color)
+bool Bitmap::isMapped() const
 {
-    const std::uint32_t index{(m_width * y + x) * 4U};
-    m_data[index] = color.r;
-    m_data[index + 1U] = color.g;
-    m_data[index + 2U] = color.b;
-    m_data[index + 3U] = color.a;
+    return m_file != nullptr;
+}
+
+bool Bitmap::isWritable() const
+{
+    return m_writablePixels != nullptr;
+}
+
+std::vector<std::uint8_t> Bitmap::copyData() const
+{
+    const std::size_t rowSize{static_cast<std::size_t>(m_width) * 4U};
+    std::vector<std::uint8_t> data(rowSize * m_height);
+    for(std::size_t y = 0; y < m_height; y++) {
+        const std::uint8_t* const row{m_pixels + y * m_stride};
+        std::copy(row, row + rowSize, data.begin() + static_cast<std::ptrdiff_t>(y * rowSize));
+    }
+    return data;
+}
+
+const std::vector<std::uint8_t>& Bitmap::getDataRef() const
+{
+    if(!m_packedData) {
+        m_packedData = std::unique_ptr<std::vector<std::uint8_t>>(new std::vector<std::uint8_t>(copyData()));
+    }
+    return *m_packedData;
 }
 
 void Bitmap::fill(const geometrize::rgba color)
 {
-    for(std::size_t i = 0; i < m_data.size(); i += 4U) {
-        m_data[i] = color.r;
-        m_data[i + 1U] = color.g;
-        m_data[i + 2U] = color.b;
-        m_data[i + 3U] = color.a;
+    assert(m_writablePixels && "Cannot fill a read-only bitmap");
+    for(std::uint32_t y = 0; y < m_height; y++) {
+        std::uint8_t* const row{writableRowPtr(y)};
+        for(std::size_t i = 0; i < static_cast<std::size_t>(m_width) * 4U; i += 4U) {
+            row[i] = color.r;
+            row[i + 1U] = color.g;
+            row[i + 2U] = color.b;
+            row[i + 3U] = color.a;
+        }
     }
 }
 
@@ -1,15 +1,28 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "alignedallocator.h"
+#include "bitmapview.h"
 #include "rgba.h"
 
+namespace geometrize
+{
+class MappedFile;
+}
+
 namespace geometrize
 {
 
 /**
  * @brief The Bitmap class is a helper class for working with bitmap data.
+ * A bitmap either owns its pixel data, is a read-only bitmap that borrows the pixel data of a bitmap view, or keeps its pixel data in a memory mapped file.
+ * Copying a bitmap that borrows its data or maps a read-only file does not copy the pixel data. Copying a bitmap that maps a writable file makes a copy in memory.
+ * Owned pixel data is aligned to BITMAP_ALIGNMENT bytes, and each row is padded to a multiple of that, so every row starts on an aligned address.
  * @author Sam Twidale (https://samcodes.co.uk/)
  */
 class Bitmap
@@ -31,9 +44,27 @@ public:
      */
     Bitmap(std::uint32_t width, std::uint32_t height, const std::vector<std::uint8_t>& data);
 
+    /**
+     * @brief Bitmap Creates a read-only bitmap that borrows the pixel data of the given view, without copying it.
+     * The pixel data must outlive the bitmap and any copies of it. The pixels of a borrowing bitmap cannot be set.
+     * @param view The view of the pixel data.
+     */
+    explicit Bitmap(const geometrize::BitmapView& view);
+
+    /**
+     * @brief Bitmap Creates a bitmap that keeps its pixel data in a memory mapped file of raw RGBA8888 data, with the rows tightly packed.
+     * Only the parts of the file that are used are paged into memory. The bitmap is read-only if the file was not mapped writable.
+     * @param file The mapped file, must be at least width * height * depth (4) bytes long. Throws std::invalid_argument if it is shorter.
+     * @param width The width of the bitmap.
+     * @param height The height of the bitmap.
+     */
+    Bitmap(std::shared_ptr<geometrize::MappedFile> file, std::uint32_t width, std::uint32_t height);
+
     ~Bitmap() = default;
-    Bitmap& operator=(const geometrize::Bitmap&) = default;
-    Bitmap(const geometrize::Bitmap&) = default;
+    Bitmap& operator=(const geometrize::Bitmap& other);
+    Bitmap(const geometrize::Bitmap& other);
+    Bitmap& operator=(geometrize::Bitmap&& other) = default;
+    Bitmap(geometrize::Bitmap&& other) = default;
 
     /**
      * @brief getWidth Gets the width of the bitmap.
@@ -46,35 +77,139 @@ public:
     std::uint32_t getHeight() const;
 
     /**
-     * @brief copyData Gets a copy of the raw bitmap data.
+     * @brief getStride Gets the distance in bytes from the start of one row of the bitmap data to the start of the next.
+     * For owned data this is width * depth (4) rounded up to a multiple of BITMAP_ALIGNMENT. For borrowed data it is the stride of the view, and for mapped data width * depth (4).
+     */
+    std::size_t getStride() const;
+
+    /**
+     * @brief getData Gets a pointer to the first byte of the first row of the bitmap data.
+     * @return The bitmap data, rows are getStride() bytes apart.
+     */
+    const std::uint8_t* getData() const;
+
+    /**
+     * @brief getView Gets a view of the bitmap data.
+     * @return A view of the bitmap data, valid for as long as the bitmap data is.
+     */
+    geometrize::BitmapView getView() const;
+
+    /**
+     * @brief isBorrowed Returns true if the bitmap borrows its pixel data from a bitmap view, rather than owning it.
+     * @return True if the bitmap data is borrowed, else false.
+     */
+    bool isBorrowed() const;
+
+    /**
+     * @brief isMapped Returns true if the bitmap keeps its pixel data in a memory mapped file.
+     * @return True if the bitmap data is mapped, else false.
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief isWritable Returns true if the pixels of the bitmap can be set, which is the case unless the data is borrowed or mapped read-only.
+     * @return True if the bitmap is writable, else false.
+     */
+    bool isWritable() const;
+
+    /**
+     * @brief copyData Gets a copy of the raw bitmap data, with the rows tightly packed.
      * @return The bitmap data.
      */
     std::vector<std::uint8_t> copyData() const;
 
     /**
-     * @brief getDataRef Gets a reference to the raw bitmap data.
+     * @brief getDataRef Gets a reference to the raw bitmap data, with the rows tightly packed.
+     * @deprecated Bitmap data is no longer kept packed, so this makes a packed copy on first use and keeps it until the pixels are next written, which invalidates the reference.
+     * Unlike the other const methods it is not safe to call from several threads at once. Use getData() and getStride(), rowPtr() or copyData() instead.
      * @return The bitmap data.
      */
+    [[deprecated("Use getData() and getStride(), rowPtr() or copyData() instead")]]
     const std::vector<std::uint8_t>& getDataRef() const;
 
+    /**
+     * @brief rowPtr Gets a pointer to the first byte of a row of the bitmap data.
+     * @param y The y-coordinate of the row.
+     * @return The row data, getWidth() * depth (4) bytes long.
+     */
+    const std::uint8_t* rowPtr(const std::uint32_t y) const
+    {
+        assert(y < m_height);
+        return m_pixels + static_cast<std::size_t>(y) * m_stride;
+    }
+
+    /**
+     * @brief writableRowPtr Gets a pointer to the first byte of a row of the bitmap data for writing. The bitmap must be writable.
+     * @param y The y-coordinate of the row.
+     * @return The row data, getWidth() * depth (4) bytes long.
+     */
+    std::uint8_t* writableRowPtr(const std::uint32_t y)
+    {
+        assert(m_writablePixels && "Cannot write to the pixels of a read-only bitmap");
+        assert(y < m_height);
+        if(m_packedData) {
+            m_packedData.reset(); // The packed copy made by getDataRef is out of date once the pixels are written
+        }
+        return m_writablePixels + static_cast<std::size_t>(y) * m_stride;
+    }
+
+    /**
+     * @brief span Gets a pointer to the first byte of a horizontal span of pixels in the bitmap data.
+     * @param y The y-coordinate of the span.
+     * @param x1 The x-coordinate of the first pixel of the span.
+     * @param x2 The x-coordinate of the last pixel of the span (inclusive, like scanlines).
+     * @return The span data, (x2 - x1 + 1) * depth (4) bytes long.
+     */
+    const std::uint8_t* span(const std::uint32_t y, const std::uint32_t x1, const std::uint32_t x2) const
+    {
+        assert(x1 <= x2 && x2 < m_width);
+        static_cast<void>(x2);
+        return rowPtr(y) + static_cast<std::size_t>(x1) * 4U;
+    }
+
+    /**
+     * @brief writableSpan Gets a pointer to the first byte of a horizontal span of pixels in the bitmap data for writing. The bitmap must be writable.
+     * @param y The y-coordinate of the span.
+     * @param x1 The x-coordinate of the first pixel of the span.
+     * @param x2 The x-coordinate of the last pixel of the span (inclusive, like scanlines).
+     * @return The span data, (x2 - x1 + 1) * depth (4) bytes long.
+     */
+    std::uint8_t* writableSpan(const std::uint32_t y, const std::uint32_t x1, const std::uint32_t x2)
+    {
+        assert(x1 <= x2 && x2 < m_width);
+        static_cast<void>(x2);
+        return writableRowPtr(y) + static_cast<std::size_t>(x1) * 4U;
+    }
+
     /**
      * @brief getPixel Gets a pixel color value.
      * @param x The x-coordinate of the pixel.
      * @param y The y-coordinate of the pixel.
      * @return The pixel RGBA color value.
      */
-    geometrize::rgba getPixel(std::uint32_t x, std::uint32_t y) const;
+    geometrize::rgba getPixel(const std::uint32_t x, const std::uint32_t y) const
+    {
+        const std::uint8_t* const pixel{span(y, x, x)};
+        return geometrize::rgba{pixel[0], pixel[1], pixel[2], pixel[3]};
+    }
 
     /**
-     * @brief setPixel Sets a pixel color value.
+     * @brief setPixel Sets a pixel color value. The bitmap must be writable.
      * @param x The x-coordinate of the pixel.
      * @param y The y-coordinate of the pixel.
      * @param color The pixel RGBA color value.
      */
-    void setPixel(std::uint32_t x, std::uint32_t y, geometrize::rgba color);
+    void setPixel(const std::uint32_t x, const std::uint32_t y, const geometrize::rgba color)
+    {
+        std::uint8_t* const pixel{writableSpan(y, x, x)};
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+        pixel[3] = color.a;
+    }
 
     /**
-     * @brief fill Fills the bitmap with the given color.
+     * @brief fill Fills the bitmap with the given color. The bitmap must be writable.
      * @param color The color to fill the bitmap with.
      */
     void fill(geometrize::rgba color);
@@ -82,7 +217,13 @@ public:
 private:
     std::uint32_t m_width; ///< The width of the bitmap.
     std::uint32_t m_height; ///< The height of the bitmap.
-    std::vector<std::uint8_t> m_data; ///< The bitmap data.
+    std::vector<std::uint8_t, geometrize::AlignedAllocator<std::uint8_t>> m_data; ///< The bitmap data with padded rows, empty if the data is borrowed or mapped.
+    const std::uint8_t* m_pixels; ///< The first byte of the bitmap data, wherever it is kept.
+    std::uint8_t* m_writablePixels; ///< The first byte of the bitmap data for writing, or null if the bitmap is read-only.
+    std::size_t m_stride; ///< The distance in bytes from the start of one row to the start of the next.
+    bool m_borrowed; ///< Whether the bitmap data is borrowed from a view.
+    std::shared_ptr<geometrize::MappedFile> m_file; ///< The memory mapped file the bitmap data is kept in, or null if it is not mapped.
+    mutable std::unique_ptr<std::vector<std::uint8_t>> m_packedData; ///< The packed copy of the bitmap data made by getDataRef, or null if there is none.
 };
 
 }
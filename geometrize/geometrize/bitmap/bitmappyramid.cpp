@@ -0,0 +1,145 @@
+#include "bitmappyramid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GEOMETRIZE_PYRAMID_SSE2
+#endif
+
+#include "bitmap.h"
+#include "rgba.h"
+#include "../rasterizer/scanline.h"
+#include "../rasterizer/scanlineset.h"
+
+namespace
+{
+
+/**
+ * @brief downsampleSpan Box filters pixels x1 to x2 (inclusive) of a row of the destination from the two source rows under it.
+ * Pixels past the right edge of the source are taken to repeat the last column, and the caller passes the same row twice past the bottom edge, which makes the edge pixels the rounded average of the pixels they cover.
+ */
+void downsampleSpan(const std::uint8_t* const row0, const std::uint8_t* const row1, const std::uint32_t sourceWidth, std::uint8_t* const destination, const std::uint32_t x1, const std::uint32_t x2)
+{
+    std::uint32_t x{x1};
+
+#if defined(GEOMETRIZE_PYRAMID_SSE2)
+    // Two destination pixels at a time, from four source pixels on each row
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i two{_mm_set1_epi16(2)};
+    for(; x < x2 && 2U * x + 3U < sourceWidth; x += 2U) {
+        const __m128i top{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + static_cast<std::size_t>(x) * 8U))};
+        const __m128i bottom{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + static_cast<std::size_t>(x) * 8U))};
+        const __m128i left{_mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero))};
+        const __m128i right{_mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero))};
+        const __m128i sums{_mm_add_epi16(_mm_unpacklo_epi64(left, right), _mm_unpackhi_epi64(left, right))};
+        const __m128i averages{_mm_srli_epi16(_mm_add_epi16(sums, two), 2)};
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + static_cast<std::size_t>(x) * 4U), _mm_packus_epi16(averages, averages));
+    }
+#endif
+
+    for(; x <= x2; x++) {
+        const std::size_t left{static_cast<std::size_t>(2U * x) * 4U};
+        const std::size_t right{static_cast<std::size_t>((std::min)(2U * x + 1U, sourceWidth - 1U)) * 4U};
+        for(std::size_t c = 0; c < 4U; c++) {
+            const std::uint32_t sum{static_cast<std::uint32_t>(row0[left + c]) + row0[right + c] + row1[left + c] + row1[right + c]};
+            destination[static_cast<std::size_t>(x) * 4U + c] = static_cast<std::uint8_t>((sum + 2U) >> 2U);
+        }
+    }
+}
+
+/**
+ * @brief downsampleRow Box filters pixels x1 to x2 (inclusive) of row y of the destination from the source.
+ */
+void downsampleRow(const geometrize::Bitmap& source, geometrize::Bitmap& destination, const std::uint32_t y, const std::uint32_t x1, const std::uint32_t x2)
+{
+    const std::uint32_t sourceY{2U * y};
+    const std::uint8_t* const row0{source.rowPtr(sourceY)};
+    const std::uint8_t* const row1{sourceY + 1U < source.getHeight() ? source.rowPtr(sourceY + 1U) : row0};
+    downsampleSpan(row0, row1, source.getWidth(), destination.writableRowPtr(y), x1, x2);
+}
+
+}
+
+namespace geometrize
+{
+
+BitmapPyramid::BitmapPyramid(const geometrize::Bitmap& base, const std::uint32_t levelCount) :
+    m_baseWidth{base.getWidth()}, m_baseHeight{base.getHeight()}, m_levels{}
+{
+    m_levels.reserve(levelCount);
+    const geometrize::Bitmap* source{&base};
+    while(m_levels.size() < levelCount && (source->getWidth() > 1U || source->getHeight() > 1U)) {
+        const std::uint32_t width{(source->getWidth() + 1U) / 2U};
+        const std::uint32_t height{(source->getHeight() + 1U) / 2U};
+        m_levels.emplace_back(width, height, geometrize::rgba{0, 0, 0, 0});
+        if(width != 0) {
+            for(std::uint32_t y = 0; y < height; y++) {
+                downsampleRow(*source, m_levels.back(), y, 0, width - 1U);
+            }
+        }
+        source = &m_levels.back();
+    }
+}
+
+std::size_t BitmapPyramid::getLevelCount() const
+{
+    return m_levels.size();
+}
+
+const geometrize::Bitmap& BitmapPyramid::getLevel(const std::size_t level) const
+{
+    assert(level >= 1U && level <= m_levels.size());
+    return m_levels[level - 1U];
+}
+
+void BitmapPyramid::update(const geometrize::Bitmap& base, const std::vector<geometrize::Scanline>& lines)
+{
+    updateLines(base, lines);
+}
+
+void BitmapPyramid::update(const geometrize::Bitmap& base, const geometrize::ScanlineSet& lines)
+{
+    updateLines(base, lines);
+}
+
+template<typename Lines> void BitmapPyramid::updateLines(const geometrize::Bitmap& base, const Lines& lines)
+{
+    assert(base.getWidth() == m_baseWidth && base.getHeight() == m_baseHeight);
+
+    // Clip the changed scanlines to the base bitmap
+    const std::int32_t baseWidth{static_cast<std::int32_t>(m_baseWidth)};
+    const std::int32_t baseHeight{static_cast<std::int32_t>(m_baseHeight)};
+    std::vector<geometrize::Scanline> changed;
+    geometrize::forEachSpan(lines, [&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        if(y >= 0 && y < baseHeight && x2 >= 0 && x1 < baseWidth && x1 <= x2) {
+            changed.push_back(geometrize::Scanline(y, (std::max)(x1, 0), (std::min)(x2, baseWidth - 1)));
+        }
+    });
+
+    // Halve the changed scanlines at each level, merging the ones that now overlap so each pixel is filtered once
+    const geometrize::Bitmap* source{&base};
+    for(geometrize::Bitmap& level : m_levels) {
+        std::vector<geometrize::Scanline> halved;
+        halved.reserve(changed.size());
+        for(const geometrize::Scanline& line : changed) {
+            halved.push_back(geometrize::Scanline(line.y / 2, line.x1 / 2, line.x2 / 2));
+        }
+
+        changed.clear();
+        geometrize::ScanlineSet(halved).forEachSpan([&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+            downsampleRow(*source, level, static_cast<std::uint32_t>(y), static_cast<std::uint32_t>(x1), static_cast<std::uint32_t>(x2));
+            changed.push_back(geometrize::Scanline(y, x1, x2));
+        });
+        if(changed.empty()) {
+            return;
+        }
+        source = &level;
+    }
+}
+
+}
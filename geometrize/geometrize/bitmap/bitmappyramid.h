@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitmap.h"
+
+namespace geometrize
+{
+class Scanline;
+class ScanlineSet;
+}
+
+namespace geometrize
+{
+
+/**
+ * @brief The BitmapPyramid class holds successively halved copies of a bitmap, for multi-resolution work such as previews and coarse candidate screening.
+ * Each level is made from the one above it with a 2x2 box filter, rounding to nearest. Where a level has an odd width or height, the last column or row averages only the pixels it covers.
+ * The pyramid does not keep the base bitmap itself. Level 1 is half the size of the base bitmap, level 2 a quarter, and so on.
+ * After drawing to the base bitmap, the pyramid can be brought back in sync by re-filtering only the pixels under the changed scanlines.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class BitmapPyramid
+{
+public:
+    /**
+     * @brief BitmapPyramid Creates a pyramid of halved copies of the given bitmap.
+     * @param base The bitmap to build the pyramid from.
+     * @param levelCount The maximum number of levels to build. Fewer are built if a level reaches a size of 1x1 pixels first.
+     */
+    BitmapPyramid(const geometrize::Bitmap& base, std::uint32_t levelCount);
+
+    ~BitmapPyramid() = default;
+    BitmapPyramid& operator=(const geometrize::BitmapPyramid&) = default;
+    BitmapPyramid(const geometrize::BitmapPyramid&) = default;
+    BitmapPyramid& operator=(geometrize::BitmapPyramid&&) = default;
+    BitmapPyramid(geometrize::BitmapPyramid&&) = default;
+
+    /**
+     * @brief getLevelCount Gets the number of levels in the pyramid, not counting the base bitmap.
+     * @return The number of levels.
+     */
+    std::size_t getLevelCount() const;
+
+    /**
+     * @brief getLevel Gets a level of the pyramid.
+     * @param level The level, from 1 (half the size of the base bitmap) to getLevelCount().
+     * @return The bitmap at the given level.
+     */
+    const geometrize::Bitmap& getLevel(std::size_t level) const;
+
+    /**
+     * @brief update Re-filters the pixels of every level that lie under the given scanlines of the base bitmap, after they were drawn to.
+     * @param base The base bitmap the pyramid was built from, which must have the same size as when it was built.
+     * @param lines The scanlines of the base bitmap that changed. They may overlap, and are clipped to the bitmap.
+     */
+    void update(const geometrize::Bitmap& base, const std::vector<geometrize::Scanline>& lines);
+
+    /**
+     * @brief update Re-filters the pixels of every level that lie under the given scanlines of the base bitmap, after they were drawn to.
+     * @param base The base bitmap the pyramid was built from, which must have the same size as when it was built.
+     * @param lines The scanlines of the base bitmap that changed, which are clipped to the bitmap.
+     */
+    void update(const geometrize::Bitmap& base, const geometrize::ScanlineSet& lines);
+
+private:
+    template<typename Lines> void updateLines(const geometrize::Bitmap& base, const Lines& lines);
+
+    std::uint32_t m_baseWidth; ///< The width of the base bitmap.
+    std::uint32_t m_baseHeight; ///< The height of the base bitmap.
+    std::vector<geometrize::Bitmap> m_levels; ///< The levels of the pyramid, largest first.
+};
+
+}
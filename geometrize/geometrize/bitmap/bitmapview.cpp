@@ -0,0 +1,50 @@
+#include "bitmapview.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "rgba.h"
+
+namespace geometrize
+{
+
+BitmapView::BitmapView(const std::uint8_t* const data, const std::uint32_t width, const std::uint32_t height, const std::size_t stride) :
+    m_data{data}, m_width{width}, m_height{height}, m_stride{stride}
+{
+    assert(stride >= static_cast<std::size_t>(width) * 4U);
+    assert(data != nullptr || width == 0 || height == 0);
+}
+
+BitmapView::BitmapView(const std::uint8_t* const data, const std::uint32_t width, const std::uint32_t height) :
+    BitmapView(data, width, height, static_cast<std::size_t>(width) * 4U)
+{
+}
+
+std::uint32_t BitmapView::getWidth() const
+{
+    return m_width;
+}
+
+std::uint32_t BitmapView::getHeight() const
+{
+    return m_height;
+}
+
+std::size_t BitmapView::getStride() const
+{
+    return m_stride;
+}
+
+const std::uint8_t* BitmapView::getData() const
+{
+    return m_data;
+}
+
+geometrize::rgba BitmapView::getPixel(const std::uint32_t x, const std::uint32_t y) const
+{
+    const std::uint8_t* const pixel{m_data + static_cast<std::size_t>(y) * m_stride + static_cast<std::size_t>(x) * 4U};
+    return geometrize::rgba{pixel[0], pixel[1], pixel[2], pixel[3]};
+}
+
+}
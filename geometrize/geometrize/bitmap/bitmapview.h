@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rgba.h"
+
+namespace geometrize
+{
+
+/**
+ * @brief The BitmapView class is a read-only, non-owning view of RGBA8888 pixel data held elsewhere, such as in a buffer owned by an image decoder.
+ * Rows may be padded, so each row starts stride bytes after the one before it. The pixel data must outlive the view and anything created from it.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class BitmapView
+{
+public:
+    /**
+     * @brief BitmapView Creates a view of the given pixel data.
+     * @param data The pixel data, RGBA8888, must be at least stride * (height - 1) + width * depth (4) bytes long.
+     * @param width The width of the bitmap.
+     * @param height The height of the bitmap.
+     * @param stride The distance in bytes from the start of one row to the start of the next, must be at least width * depth (4).
+     */
+    BitmapView(const std::uint8_t* data, std::uint32_t width, std::uint32_t height, std::size_t stride);
+
+    /**
+     * @brief BitmapView Creates a view of tightly packed pixel data, with rows width * depth (4) bytes apart.
+     * @param data The pixel data, RGBA8888, must be width * height * depth (4) bytes long.
+     * @param width The width of the bitmap.
+     * @param height The height of the bitmap.
+     */
+    BitmapView(const std::uint8_t* data, std::uint32_t width, std::uint32_t height);
+
+    /**
+     * @brief getWidth Gets the width of the bitmap.
+     */
+    std::uint32_t getWidth() const;
+
+    /**
+     * @brief getHeight Gets the height of the bitmap.
+     */
+    std::uint32_t getHeight() const;
+
+    /**
+     * @brief getStride Gets the distance in bytes from the start of one row to the start of the next.
+     */
+    std::size_t getStride() const;
+
+    /**
+     * @brief getData Gets a pointer to the first byte of the first row of pixel data.
+     */
+    const std::uint8_t* getData() const;
+
+    /**
+     * @brief getPixel Gets a pixel color value.
+     * @param x The x-coordinate of the pixel.
+     * @param y The y-coordinate of the pixel.
+     * @return The pixel RGBA color value.
+     */
+    geometrize::rgba getPixel(std::uint32_t x, std::uint32_t y) const;
+
+private:
+    const std::uint8_t* m_data; ///< The pixel data.
+    std::uint32_t m_width; ///< The width of the bitmap.
+    std::uint32_t m_height; ///< The height of the bitmap.
+    std::size_t m_stride; ///< The distance in bytes from the start of one row to the start of the next.
+};
+
+}
@@ -0,0 +1,123 @@
+#include "mappedfile.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GEOMETRIZE_HAS_MMAP
+#endif
+
+namespace
+{
+
+#if defined(GEOMETRIZE_HAS_MMAP)
+/**
+ * @brief mapDescriptor Maps the given open file into memory and closes the file descriptor, which the mapping does not need.
+ */
+std::uint8_t* mapDescriptor(const int descriptor, const std::size_t size, const bool writable, const std::string& path)
+{
+    void* const memory{size == 0 ? nullptr : mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, descriptor, 0)};
+    const int error{errno};
+    close(descriptor);
+    if(memory == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "Failed to map " + path);
+    }
+
+    // Shapes touch scattered parts of the image, so reading ahead is mostly wasted
+    if(memory) {
+        static_cast<void>(madvise(memory, size, MADV_RANDOM));
+    }
+    return static_cast<std::uint8_t*>(memory);
+}
+#endif
+
+}
+
+namespace geometrize
+{
+
+std::shared_ptr<geometrize::MappedFile> MappedFile::open(const std::string& path, const bool writable)
+{
+#if defined(GEOMETRIZE_HAS_MMAP)
+    const int descriptor{::open(path.c_str(), writable ? O_RDWR : O_RDONLY)};
+    if(descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to open " + path);
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0) {
+        const int error{errno};
+        close(descriptor);
+        throw std::system_error(error, std::generic_category(), "Failed to get the size of " + path);
+    }
+    const std::size_t size{static_cast<std::size_t>(status.st_size)};
+    return std::shared_ptr<geometrize::MappedFile>(new geometrize::MappedFile(mapDescriptor(descriptor, size, writable, path), size, writable));
+#else
+    static_cast<void>(path);
+    static_cast<void>(writable);
+    throw std::runtime_error("Memory mapped files are not supported on this platform");
+#endif
+}
+
+std::shared_ptr<geometrize::MappedFile> MappedFile::create(const std::string& path, const std::uint64_t size)
+{
+#if defined(GEOMETRIZE_HAS_MMAP)
+    const int descriptor{::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if(descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to create " + path);
+    }
+    if(ftruncate(descriptor, static_cast<off_t>(size)) != 0) {
+        const int error{errno};
+        close(descriptor);
+        throw std::system_error(error, std::generic_category(), "Failed to set the size of " + path);
+    }
+    return std::shared_ptr<geometrize::MappedFile>(new geometrize::MappedFile(mapDescriptor(descriptor, static_cast<std::size_t>(size), true, path), static_cast<std::size_t>(size), true));
+#else
+    static_cast<void>(path);
+    static_cast<void>(size);
+    throw std::runtime_error("Memory mapped files are not supported on this platform");
+#endif
+}
+
+MappedFile::MappedFile(std::uint8_t* const data, const std::size_t size, const bool writable) : m_data{data}, m_size{size}, m_writable{writable}
+{
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(GEOMETRIZE_HAS_MMAP)
+    if(m_data) {
+        munmap(m_data, m_size);
+    }
+#endif
+}
+
+const std::uint8_t* MappedFile::getData() const
+{
+    return m_data;
+}
+
+std::uint8_t* MappedFile::getWritableData() const
+{
+    return m_writable ? m_data : nullptr;
+}
+
+std::size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+
+bool MappedFile::isWritable() const
+{
+    return m_writable;
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace geometrize
+{
+
+/**
+ * @brief The MappedFile class maps a file into memory, so that the operating system pages in only the parts of it that are used.
+ * Bitmaps can be backed by mapped files of raw RGBA8888 pixel data, which allows for images far larger than would fit in memory.
+ * Only supported on platforms with POSIX mmap, elsewhere creating a mapping throws.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief open Maps an existing file into memory.
+     * @param path The path to the file.
+     * @param writable Whether the mapping can be written to, changes are written back to the file.
+     * @return The mapped file. Throws std::system_error if the file cannot be opened or mapped.
+     */
+    static std::shared_ptr<geometrize::MappedFile> open(const std::string& path, bool writable);
+
+    /**
+     * @brief create Creates a file of the given size, or truncates an existing one, and maps it into memory for writing. The file is filled with zeros.
+     * @param path The path to the file.
+     * @param size The size of the file in bytes.
+     * @return The mapped file. Throws std::system_error if the file cannot be created or mapped.
+     */
+    static std::shared_ptr<geometrize::MappedFile> create(const std::string& path, std::uint64_t size);
+
+    ~MappedFile();
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(const MappedFile&) = delete;
+
+    /**
+     * @brief getData Gets a pointer to the start of the mapping.
+     */
+    const std::uint8_t* getData() const;
+
+    /**
+     * @brief getWritableData Gets a pointer to the start of the mapping for writing, the file must have been mapped writable.
+     */
+    std::uint8_t* getWritableData() const;
+
+    /**
+     * @brief getSize Gets the size of the mapping in bytes.
+     */
+    std::size_t getSize() const;
+
+    /**
+     * @brief isWritable Returns true if the mapping can be written to.
+     */
+    bool isWritable() const;
+
+private:
+    MappedFile(std::uint8_t* data, std::size_t size, bool writable);
+
+    std::uint8_t* m_data; ///< The start of the mapping.
+    std::size_t m_size; ///< The size of the mapping in bytes.
+    bool m_writable; ///< Whether the mapping can be written to.
+};
+
+}
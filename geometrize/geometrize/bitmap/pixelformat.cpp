@@ -0,0 +1,289 @@
+#include "pixelformat.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define GEOMETRIZE_PIXELFORMAT_SSSE3
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GEOMETRIZE_PIXELFORMAT_SSE2
+#endif
+
+#include "bitmap.h"
+#include "rgba.h"
+
+namespace
+{
+
+/**
+ * @brief The Swizzle struct gives, for each byte of a four byte output pixel, the byte of the four byte source pixel to take it from.
+ */
+struct Swizzle
+{
+    std::uint8_t from[4]; ///< The source byte for each output byte.
+};
+
+/**
+ * @brief getSwizzleToRgba Gets the swizzle that turns a four byte pixel of the given format into RGBA8888.
+ */
+Swizzle getSwizzleToRgba(const geometrize::PixelFormat format)
+{
+    switch(format) {
+        case geometrize::PixelFormat::BGRA8888:
+        case geometrize::PixelFormat::BGRA8888_PREMULTIPLIED:
+            return Swizzle{{2, 1, 0, 3}};
+        case geometrize::PixelFormat::ARGB8888:
+            return Swizzle{{1, 2, 3, 0}};
+        default:
+            return Swizzle{{0, 1, 2, 3}};
+    }
+}
+
+/**
+ * @brief getSwizzleFromRgba Gets the swizzle that turns an RGBA8888 pixel into a four byte pixel of the given format.
+ */
+Swizzle getSwizzleFromRgba(const geometrize::PixelFormat format)
+{
+    switch(format) {
+        case geometrize::PixelFormat::BGRA8888:
+        case geometrize::PixelFormat::BGRA8888_PREMULTIPLIED:
+            return Swizzle{{2, 1, 0, 3}};
+        case geometrize::PixelFormat::ARGB8888:
+            return Swizzle{{3, 0, 1, 2}};
+        default:
+            return Swizzle{{0, 1, 2, 3}};
+    }
+}
+
+/**
+ * @brief isPremultiplied Returns true if the colors of the given format are premultiplied by alpha.
+ */
+bool isPremultiplied(const geometrize::PixelFormat format)
+{
+    return format == geometrize::PixelFormat::RGBA8888_PREMULTIPLIED || format == geometrize::PixelFormat::BGRA8888_PREMULTIPLIED;
+}
+
+/**
+ * @brief getUnpremultiplyTable Gets a table of each color value divided by each alpha value with rounding, indexed by alpha * 256 + color.
+ * Colors above their alpha (not validly premultiplied) clamp to 255, and all colors become 0 when alpha is 0.
+ */
+const std::vector<std::uint8_t>& getUnpremultiplyTable()
+{
+    static const std::vector<std::uint8_t> table{[]() {
+        std::vector<std::uint8_t> values(256U * 256U, 0);
+        for(std::uint32_t a = 1; a < 256U; a++) {
+            for(std::uint32_t c = 0; c < 256U; c++) {
+                values[a * 256U + c] = static_cast<std::uint8_t>((std::min)((c * 255U + a / 2U) / a, 255U));
+            }
+        }
+        return values;
+    }()};
+    return table;
+}
+
+/**
+ * @brief unpremultiplyRow Divides the colors of a row of RGBA8888 pixels by their alpha, with rounding.
+ */
+void unpremultiplyRow(std::uint8_t* const row, const std::uint32_t width)
+{
+    const std::uint8_t* const table{getUnpremultiplyTable().data()};
+    for(std::size_t i = 0; i < static_cast<std::size_t>(width) * 4U; i += 4U) {
+        const std::uint8_t* const divided{table + static_cast<std::size_t>(row[i + 3U]) * 256U};
+        row[i] = divided[row[i]];
+        row[i + 1U] = divided[row[i + 1U]];
+        row[i + 2U] = divided[row[i + 2U]];
+    }
+}
+
+/**
+ * @brief premultiplyRow Multiplies the colors of a row of pixels with alpha in the last byte (RGBA8888 or BGRA8888) by their alpha, with rounding.
+ */
+void premultiplyRow(std::uint8_t* const row, const std::uint32_t width)
+{
+    std::size_t i{0};
+
+#if defined(GEOMETRIZE_PIXELFORMAT_SSE2)
+    // Four pixels at a time in 16-bit lanes, multiplying alpha by 255 so it comes out unchanged
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i colorLanes{_mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0)};
+    const __m128i alphaLanes{_mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255)};
+    const __m128i half{_mm_set1_epi16(128)};
+    const auto premultiply = [&](const __m128i pixels) {
+        const __m128i alphas{_mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3))};
+        const __m128i t{_mm_add_epi16(_mm_mullo_epi16(pixels, _mm_or_si128(_mm_and_si128(alphas, colorLanes), alphaLanes)), half)};
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    };
+    for(; i + 16U <= static_cast<std::size_t>(width) * 4U; i += 16U) {
+        const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i))};
+        const __m128i low{premultiply(_mm_unpacklo_epi8(pixels, zero))};
+        const __m128i high{premultiply(_mm_unpackhi_epi8(pixels, zero))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for(; i < static_cast<std::size_t>(width) * 4U; i += 4U) {
+        const std::uint32_t a{row[i + 3U]};
+        for(std::size_t c = 0; c < 3U; c++) {
+            const std::uint32_t t{row[i + c] * a + 128U};
+            row[i + c] = static_cast<std::uint8_t>((t + (t >> 8U)) >> 8U);
+        }
+    }
+}
+
+/**
+ * @brief swizzleRow Reorders the bytes of a row of four byte pixels.
+ */
+void swizzleRow(const std::uint8_t* const source, std::uint8_t* const destination, const std::uint32_t width, const Swizzle& swizzle)
+{
+    std::uint32_t x{0};
+
+#if defined(GEOMETRIZE_PIXELFORMAT_SSSE3)
+    const __m128i mask{_mm_setr_epi8(
+        static_cast<char>(swizzle.from[0]), static_cast<char>(swizzle.from[1]), static_cast<char>(swizzle.from[2]), static_cast<char>(swizzle.from[3]),
+        static_cast<char>(swizzle.from[0] + 4), static_cast<char>(swizzle.from[1] + 4), static_cast<char>(swizzle.from[2] + 4), static_cast<char>(swizzle.from[3] + 4),
+        static_cast<char>(swizzle.from[0] + 8), static_cast<char>(swizzle.from[1] + 8), static_cast<char>(swizzle.from[2] + 8), static_cast<char>(swizzle.from[3] + 8),
+        static_cast<char>(swizzle.from[0] + 12), static_cast<char>(swizzle.from[1] + 12), static_cast<char>(swizzle.from[2] + 12), static_cast<char>(swizzle.from[3] + 12))};
+    for(; x + 4U <= width; x += 4U) {
+        const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<std::size_t>(x) * 4U))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + static_cast<std::size_t>(x) * 4U), _mm_shuffle_epi8(pixels, mask));
+    }
+#elif defined(GEOMETRIZE_PIXELFORMAT_SSE2)
+    // Without byte shuffles, move each byte of the 32-bit pixels into place with shifts and masks, x86 being little-endian
+    const __m128i low{_mm_set1_epi32(0xFF)};
+    __m128i right[4];
+    __m128i left[4];
+    for(std::size_t c = 0; c < 4U; c++) {
+        right[c] = _mm_cvtsi32_si128(static_cast<int>(swizzle.from[c]) * 8);
+        left[c] = _mm_cvtsi32_si128(static_cast<int>(c) * 8);
+    }
+    for(; x + 4U <= width; x += 4U) {
+        const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<std::size_t>(x) * 4U))};
+        __m128i result{_mm_setzero_si128()};
+        for(std::size_t c = 0; c < 4U; c++) {
+            result = _mm_or_si128(result, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(pixels, right[c]), low), left[c]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + static_cast<std::size_t>(x) * 4U), result);
+    }
+#endif
+
+    for(; x < width; x++) {
+        const std::uint8_t* const s{source + static_cast<std::size_t>(x) * 4U};
+        std::uint8_t* const d{destination + static_cast<std::size_t>(x) * 4U};
+        const std::uint8_t p[4]{s[0], s[1], s[2], s[3]};
+        for(std::size_t c = 0; c < 4U; c++) {
+            d[c] = p[swizzle.from[c]];
+        }
+    }
+}
+
+/**
+ * @brief expandRgbRow Turns a row of RGB888 pixels into opaque RGBA8888 pixels.
+ */
+void expandRgbRow(const std::uint8_t* const source, std::uint8_t* const destination, const std::uint32_t width)
+{
+    std::uint32_t x{0};
+
+#if defined(GEOMETRIZE_PIXELFORMAT_SSSE3)
+    // Four pixels at a time, loading 16 bytes of which 12 are used, so stop while 16 bytes are left to read
+    const __m128i mask{_mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1)};
+    const __m128i alpha{_mm_set1_epi32(static_cast<int>(0xFF000000U))};
+    for(; x + 6U <= width; x += 4U) {
+        const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<std::size_t>(x) * 3U))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + static_cast<std::size_t>(x) * 4U), _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha));
+    }
+#endif
+
+    for(; x < width; x++) {
+        const std::uint8_t* const s{source + static_cast<std::size_t>(x) * 3U};
+        std::uint8_t* const d{destination + static_cast<std::size_t>(x) * 4U};
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+        d[3] = UINT8_MAX;
+    }
+}
+
+/**
+ * @brief packRgbRow Turns a row of RGBA8888 pixels into RGB888 pixels, dropping alpha.
+ */
+void packRgbRow(const std::uint8_t* const source, std::uint8_t* const destination, const std::uint32_t width)
+{
+    std::uint32_t x{0};
+
+#if defined(GEOMETRIZE_PIXELFORMAT_SSSE3)
+    // Four pixels at a time, storing 16 bytes of which 12 are used, so stop while 16 bytes are left to write
+    const __m128i mask{_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)};
+    for(; x + 6U <= width; x += 4U) {
+        const __m128i pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<std::size_t>(x) * 4U))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + static_cast<std::size_t>(x) * 3U), _mm_shuffle_epi8(pixels, mask));
+    }
+#endif
+
+    for(; x < width; x++) {
+        const std::uint8_t* const s{source + static_cast<std::size_t>(x) * 4U};
+        std::uint8_t* const d{destination + static_cast<std::size_t>(x) * 3U};
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+    }
+}
+
+}
+
+namespace geometrize
+{
+
+std::size_t getBytesPerPixel(const geometrize::PixelFormat format)
+{
+    return format == geometrize::PixelFormat::RGB888 ? 3U : 4U;
+}
+
+geometrize::Bitmap convertToBitmap(const std::uint8_t* const data, const std::uint32_t width, const std::uint32_t height, const std::size_t stride, const geometrize::PixelFormat format)
+{
+    assert(stride >= static_cast<std::size_t>(width) * getBytesPerPixel(format));
+
+    geometrize::Bitmap bitmap(width, height, geometrize::rgba{0, 0, 0, 0});
+    const Swizzle swizzle{getSwizzleToRgba(format)};
+    for(std::uint32_t y = 0; y < height; y++) {
+        const std::uint8_t* const source{data + static_cast<std::size_t>(y) * stride};
+        std::uint8_t* const row{bitmap.writableRowPtr(y)};
+        if(format == geometrize::PixelFormat::RGB888) {
+            expandRgbRow(source, row, width);
+        } else {
+            swizzleRow(source, row, width, swizzle);
+        }
+        if(isPremultiplied(format)) {
+            unpremultiplyRow(row, width);
+        }
+    }
+    return bitmap;
+}
+
+void convertFromBitmap(const geometrize::Bitmap& bitmap, const geometrize::PixelFormat format, std::uint8_t* const destination, const std::size_t stride)
+{
+    const std::uint32_t width{bitmap.getWidth()};
+    assert(stride >= static_cast<std::size_t>(width) * getBytesPerPixel(format));
+
+    const Swizzle swizzle{getSwizzleFromRgba(format)};
+    for(std::uint32_t y = 0; y < bitmap.getHeight(); y++) {
+        const std::uint8_t* const row{bitmap.rowPtr(y)};
+        std::uint8_t* const target{destination + static_cast<std::size_t>(y) * stride};
+        if(format == geometrize::PixelFormat::RGB888) {
+            packRgbRow(row, target, width);
+            continue;
+        }
+        swizzleRow(row, target, width, swizzle);
+        if(isPremultiplied(format)) {
+            premultiplyRow(target, width);
+        }
+    }
+}
+
+}
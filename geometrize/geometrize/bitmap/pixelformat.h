@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bitmap.h"
+
+namespace geometrize
+{
+
+/**
+ * @brief The PixelFormat enum specifies the memory layouts of pixel data that bitmaps can be converted from and to.
+ * The names give the order of the channels in memory, one byte per channel. Premultiplied formats hold colors already multiplied by alpha.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+enum PixelFormat : std::uint32_t
+{
+    RGBA8888 = 0U, ///< Straight alpha, the layout bitmaps use.
+    BGRA8888 = 1U, ///< Straight alpha, as used by Qt (ARGB32 on little-endian machines) and Skia.
+    ARGB8888 = 2U, ///< Straight alpha, alpha first.
+    RGB888 = 3U, ///< No alpha channel, as produced by most image decoders. Pixels are taken to be opaque, and alpha is dropped on output.
+    RGBA8888_PREMULTIPLIED = 4U, ///< Premultiplied alpha, red first.
+    BGRA8888_PREMULTIPLIED = 5U ///< Premultiplied alpha, as used by Qt (ARGB32_Premultiplied on little-endian machines) and Skia.
+};
+
+/**
+ * @brief getBytesPerPixel Gets the number of bytes each pixel takes up in the given format.
+ * @param format The pixel format.
+ * @return The number of bytes per pixel, 3 or 4.
+ */
+std::size_t getBytesPerPixel(geometrize::PixelFormat format);
+
+/**
+ * @brief convertToBitmap Creates a bitmap from pixel data in the given format, converting it to straight RGBA8888.
+ * Swizzles are done with SSSE3 byte shuffles where available. Premultiplied colors are divided by alpha with rounding, and fully transparent pixels become transparent black.
+ * @param data The first byte of the pixel data.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param stride The distance in bytes from the start of one row of the pixel data to the start of the next.
+ * @param format The format of the pixel data.
+ * @return The new bitmap.
+ */
+geometrize::Bitmap convertToBitmap(const std::uint8_t* data, std::uint32_t width, std::uint32_t height, std::size_t stride, geometrize::PixelFormat format);
+
+/**
+ * @brief convertFromBitmap Writes the pixels of a bitmap out in the given format, for example to upload the current bitmap to a texture.
+ * Premultiplied colors are multiplied by alpha with rounding.
+ * @param bitmap The bitmap to convert.
+ * @param format The format to write the pixel data in.
+ * @param destination The first byte to write to, with room for height rows of width * getBytesPerPixel(format) bytes.
+ * @param stride The distance in bytes from the start of one row of the destination to the start of the next.
+ */
+void convertFromBitmap(const geometrize::Bitmap& bitmap, geometrize::PixelFormat format, std::uint8_t* destination, std::size_t stride);
+
+}
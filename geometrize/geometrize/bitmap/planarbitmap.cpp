@@ -0,0 +1,95 @@
+#include "planarbitmap.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "alignedallocator.h"
+#include "bitmap.h"
+
+namespace geometrize
+{
+
+PlanarBitmap::PlanarBitmap(const geometrize::Bitmap& bitmap, const bool keepAlpha) :
+    m_width{bitmap.getWidth()},
+    m_height{bitmap.getHeight()},
+    m_stride{(static_cast<std::size_t>(bitmap.getWidth()) + geometrize::BITMAP_ALIGNMENT - 1U) / geometrize::BITMAP_ALIGNMENT * geometrize::BITMAP_ALIGNMENT},
+    m_channels{keepAlpha ? 4U : 3U},
+    m_data(m_stride * m_height * m_channels)
+{
+    assert(keepAlpha || isOpaque(bitmap));
+    for(std::uint32_t y = 0; y < m_height; y++) {
+        if(m_width != 0) {
+            copySpan(bitmap, y, 0, m_width - 1U);
+        }
+    }
+}
+
+std::uint32_t PlanarBitmap::getWidth() const
+{
+    return m_width;
+}
+
+std::uint32_t PlanarBitmap::getHeight() const
+{
+    return m_height;
+}
+
+std::size_t PlanarBitmap::getStride() const
+{
+    return m_stride;
+}
+
+bool PlanarBitmap::hasAlpha() const
+{
+    return m_channels == 4U;
+}
+
+const std::uint8_t* PlanarBitmap::getRow(const std::size_t channel, const std::uint32_t y) const
+{
+    assert(channel < m_channels);
+    return m_data.data() + (channel * m_height + y) * m_stride;
+}
+
+void PlanarBitmap::copySpan(const geometrize::Bitmap& source, const std::uint32_t y, const std::uint32_t x1, const std::uint32_t x2)
+{
+    assert(source.getWidth() == m_width && source.getHeight() == m_height);
+    const std::uint8_t* const pixels{source.rowPtr(y)};
+    for(std::size_t c = 0; c < m_channels; c++) {
+        std::uint8_t* const row{m_data.data() + (c * m_height + y) * m_stride};
+        for(std::uint32_t x = x1; x <= x2; x++) {
+            row[x] = pixels[static_cast<std::size_t>(x) * 4U + c];
+        }
+    }
+}
+
+geometrize::Bitmap PlanarBitmap::toBitmap() const
+{
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(m_width) * m_height * 4U, UINT8_MAX);
+    for(std::uint32_t y = 0; y < m_height; y++) {
+        std::uint8_t* const pixels{data.data() + static_cast<std::size_t>(y) * m_width * 4U};
+        for(std::size_t c = 0; c < m_channels; c++) {
+            const std::uint8_t* const row{getRow(c, y)};
+            for(std::uint32_t x = 0; x < m_width; x++) {
+                pixels[static_cast<std::size_t>(x) * 4U + c] = row[x];
+            }
+        }
+    }
+    return geometrize::Bitmap(m_width, m_height, data);
+}
+
+bool PlanarBitmap::isOpaque(const geometrize::Bitmap& bitmap)
+{
+    for(std::uint32_t y = 0; y < bitmap.getHeight(); y++) {
+        const std::uint8_t* const pixels{bitmap.rowPtr(y)};
+        for(std::uint32_t x = 0; x < bitmap.getWidth(); x++) {
+            if(pixels[static_cast<std::size_t>(x) * 4U + 3U] != UINT8_MAX) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
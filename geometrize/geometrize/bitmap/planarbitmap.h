@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "alignedallocator.h"
+
+namespace geometrize
+{
+class Bitmap;
+}
+
+namespace geometrize
+{
+
+/**
+ * @brief The PlanarBitmap class holds the pixels of a bitmap as separate red, green, blue and alpha planes (structure of arrays), rather than interleaved.
+ * Channel-wise sums and differences over runs of pixels vectorize far better on planar data. Bitmaps that are fully opaque can drop the alpha plane.
+ * Each row of each plane starts on an address aligned to BITMAP_ALIGNMENT bytes.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class PlanarBitmap
+{
+public:
+    /**
+     * @brief PlanarBitmap Creates a planar copy of the given bitmap.
+     * @param bitmap The bitmap to copy.
+     * @param keepAlpha Whether to keep the alpha plane. If false, the bitmap must be fully opaque, and the alpha of every pixel is taken to be 255.
+     */
+    PlanarBitmap(const geometrize::Bitmap& bitmap, bool keepAlpha);
+
+    ~PlanarBitmap() = default;
+    PlanarBitmap& operator=(const geometrize::PlanarBitmap&) = default;
+    PlanarBitmap(const geometrize::PlanarBitmap&) = default;
+
+    /**
+     * @brief getWidth Gets the width of the bitmap.
+     */
+    std::uint32_t getWidth() const;
+
+    /**
+     * @brief getHeight Gets the height of the bitmap.
+     */
+    std::uint32_t getHeight() const;
+
+    /**
+     * @brief getStride Gets the distance in bytes from the start of one row of a plane to the start of the next.
+     */
+    std::size_t getStride() const;
+
+    /**
+     * @brief hasAlpha Returns true if the bitmap keeps an alpha plane, false if it is fully opaque and the alpha plane was dropped.
+     */
+    bool hasAlpha() const;
+
+    /**
+     * @brief getRow Gets a pointer to the start of a row of one of the planes.
+     * @param channel The channel of the plane, 0 for red, 1 for green, 2 for blue and 3 for alpha. The alpha plane must have been kept.
+     * @param y The y-coordinate of the row.
+     * @return The row.
+     */
+    const std::uint8_t* getRow(std::size_t channel, std::uint32_t y) const;
+
+    /**
+     * @brief copySpan Copies a run of pixels in one row from the given bitmap into the planes.
+     * @param source The bitmap to copy from, the same size as this one. If the alpha plane was dropped, the pixels copied must be opaque.
+     * @param y The y-coordinate of the row.
+     * @param x1 The leftmost x-coordinate of the run.
+     * @param x2 The rightmost x-coordinate of the run.
+     */
+    void copySpan(const geometrize::Bitmap& source, std::uint32_t y, std::uint32_t x1, std::uint32_t x2);
+
+    /**
+     * @brief toBitmap Converts the planes back to an interleaved bitmap.
+     * @return The bitmap.
+     */
+    geometrize::Bitmap toBitmap() const;
+
+    /**
+     * @brief isOpaque Returns true if every pixel of the given bitmap has an alpha of 255, in which case its alpha plane can be dropped.
+     * @param bitmap The bitmap to check.
+     * @return True if the bitmap is fully opaque, else false.
+     */
+    static bool isOpaque(const geometrize::Bitmap& bitmap);
+
+private:
+    std::uint32_t m_width; ///< The width of the bitmap.
+    std::uint32_t m_height; ///< The height of the bitmap.
+    std::size_t m_stride; ///< The distance in bytes from the start of one row of a plane to the start of the next.
+    std::size_t m_channels; ///< The number of planes kept, 4, or 3 if the alpha plane was dropped.
+    std::vector<std::uint8_t, geometrize::AlignedAllocator<std::uint8_t>> m_data; ///< The planes, one after the other.
+};
+
+}
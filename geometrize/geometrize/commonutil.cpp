@@ -10,6 +10,7 @@
 #include "bitmap/bitmap.h"
 #include "bitmap/rgba.h"
 #include "rasterizer/scanline.h"
+#include "rasterizer/scanlineset.h"
 #include "runner/imagerunneroptions.h"
 
 namespace geometrize
@@ -34,21 +35,23 @@ std::int32_t randomRange(const std::int32_t min, const std::int32_t max)
 
 geometrize::rgba getAverageImageColor(const geometrize::Bitmap& image)
 {
-    const std::vector<std::uint8_t>& data{image.getDataRef()};
-    const std::size_t size{data.size()};
-    if(size == 0) {
+    const std::size_t width{image.getWidth()};
+    const std::size_t height{image.getHeight()};
+    const std::uint64_t numPixels{static_cast<std::uint64_t>(width) * height};
+    if(numPixels == 0) {
         return geometrize::rgba{0, 0, 0, 0};
     }
 
-    const std::size_t numPixels{size / 4U};
-
-    std::uint32_t totalRed{0};
-    std::uint32_t totalGreen{0};
-    std::uint32_t totalBlue{0};
-    for(std::size_t i = 0; i < size; i += 4U) {
-        totalRed += data[i];
-        totalGreen += data[i + 1U];
-        totalBlue += data[i + 2U];
+    std::uint64_t totalRed{0};
+    std::uint64_t totalGreen{0};
+    std::uint64_t totalBlue{0};
+    for(std::uint32_t y = 0; y < height; y++) {
+        const std::uint8_t* const row{image.rowPtr(y)};
+        for(std::size_t i = 0; i < width * 4U; i += 4U) {
+            totalRed += row[i];
+            totalGreen += row[i + 1U];
+            totalBlue += row[i + 2U];
+        }
     }
 
     return geometrize::rgba{
@@ -72,6 +75,26 @@ bool scanlinesContainTransparentPixels(const std::vector<geometrize::Scanline>&
     return false;
 }
 
+bool scanlinesContainTransparentPixels(const geometrize::ScanlineSet& scanlines, const geometrize::Bitmap& image, int minAlpha)
+{
+    const std::int32_t width{static_cast<std::int32_t>(image.getWidth())};
+    const std::int32_t height{static_cast<std::int32_t>(image.getHeight())};
+    bool found{false};
+    scanlines.forEachSpan([&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        if(found || y < 0 || y >= height || x2 < 0 || x1 >= width) {
+            return;
+        }
+        const std::int32_t trimmedX2{(std::min)(x2, width - 1)};
+        for(int x = (std::max)(x1, 0); x <= trimmedX2; x++) {
+            if(image.getPixel(x, y).a < minAlpha) {
+                found = true;
+                return;
+            }
+        }
+    });
+    return found;
+}
+
 std::tuple<std::int32_t, std::int32_t, std::int32_t, std::int32_t> mapShapeBoundsToImage(const geometrize::ImageRunnerShapeBoundsOptions& options, const geometrize::Bitmap& image)
 {
     if(!options.enabled) {
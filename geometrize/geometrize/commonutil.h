@@ -11,6 +11,7 @@ namespace geometrize
 {
 class Bitmap;
 class Scanline;
+class ScanlineSet;
 struct ImageRunnerShapeBoundsOptions;
 }
 
@@ -63,6 +64,15 @@ geometrize::rgba getAverageImageColor(const geometrize::Bitmap& image);
  */
 bool scanlinesContainTransparentPixels(const std::vector<geometrize::Scanline>& scanlines, const geometrize::Bitmap& image, int minAlpha);
 
+/**
+ * @brief scanlinesContainTransparentPixels Returns true if the set of scanlines contains transparent pixels in the given image
+ * @param scanlines The scanlines to check
+ * @param image The image whose pixels to check
+ * @param minAlpha The minimum alpha level (0-255) to consider transparent
+ * @return True if the scanlines contains any transparent pixels
+ */
+bool scanlinesContainTransparentPixels(const geometrize::ScanlineSet& scanlines, const geometrize::Bitmap& image, int minAlpha);
+
 /**
  * @brief mapShapeBoundsToImage Maps the given shape bound percentages to the given image, returning a bounding rectangle, or the whole image if the bounds were invalid
  * @param The options to map to the image
@@ -1,23 +1,214 @@
 #include "core.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cmath>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "bitmap/bitmap.h"
+#include "bitmap/planarbitmap.h"
 #include "bitmap/rgba.h"
 #include "commonutil.h"
 #include "rasterizer/rasterizer.h"
 #include "rasterizer/scanline.h"
+#include "rasterizer/scanlineset.h"
+#include "rasterizer/scanlineundobuffer.h"
+#include "rasterizer/spanbatch.h"
 #include "shape/shape.h"
+#include "shape/shapearena.h"
+#include "shape/shapefactory.h"
+#include "shape/shapemutator.h"
+#include "shape/shapetypes.h"
+#include "shape/shapevalue.h"
 #include "state.h"
 
 namespace
 {
 
+/**
+* @brief computeSpanColor Calculates the color of the scanlines, shared by the scanline vector and scanline set versions of computeColor.
+*/
+template<typename Lines> geometrize::rgba computeSpanColor(
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        const Lines& lines,
+        const std::uint8_t alpha)
+{
+    // Early out to avoid integer divide by 0
+    if(lines.empty()) {
+        return geometrize::rgba{0, 0, 0, 0};
+    }
+
+    std::int64_t totalRed{0};
+    std::int64_t totalGreen{0};
+    std::int64_t totalBlue{0};
+    std::int64_t count{0};
+    const std::int32_t a{static_cast<std::int32_t>(257.0f * 255.0f / static_cast<float>(alpha))};
+
+    // For each scanline
+    geometrize::forEachSpan(lines, [&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        // Get the overlapping target and current colors
+        const std::uint8_t* const t{target.span(y, x1, x2)};
+        const std::uint8_t* const c{current.span(y, x1, x2)};
+        const std::size_t spanSize{static_cast<std::size_t>(x2 - x1 + 1) * 4U};
+        for(std::size_t i = 0; i < spanSize; i += 4U) {
+            const std::int32_t tr{t[i]};
+            const std::int32_t tg{t[i + 1U]};
+            const std::int32_t tb{t[i + 2U]};
+            const std::int32_t cr{c[i]};
+            const std::int32_t cg{c[i + 1U]};
+            const std::int32_t cb{c[i + 2U]};
+
+            // Mix the red, green and blue components, blending by the given alpha value
+            totalRed += static_cast<std::int64_t>((tr - cr) * a + cr * 257);
+            totalGreen += static_cast<std::int64_t>((tg - cg) * a + cg * 257);
+            totalBlue += static_cast<std::int64_t>((tb - cb) * a + cb * 257);
+            count++;
+        }
+    });
+
+    const std::int32_t rr{static_cast<std::int32_t>(totalRed / count) >> 8};
+    const std::int32_t gg{static_cast<std::int32_t>(totalGreen / count) >> 8};
+    const std::int32_t bb{static_cast<std::int32_t>(totalBlue / count) >> 8};
+
+    // Scale totals down to 0-255 range and return average blended color
+    const std::uint8_t r{static_cast<std::uint8_t>(geometrize::commonutil::clamp(rr, INT32_C(0), INT32_C(255)))};
+    const std::uint8_t g{static_cast<std::uint8_t>(geometrize::commonutil::clamp(gg, INT32_C(0), INT32_C(255)))};
+    const std::uint8_t b{static_cast<std::uint8_t>(geometrize::commonutil::clamp(bb, INT32_C(0), INT32_C(255)))};
+
+    return geometrize::rgba{r, g, b, alpha};
+}
+
+/**
+* @brief differenceSpans Calculates the root-mean-square error within the scanline mask, shared by the versions of differencePartial.
+* @param beforeSpan A function that gets a pointer to the pixels of a span from before the change, with the signature const std::uint8_t*(std::int32_t y, std::int32_t x1, std::int32_t x2). It is called for each span in turn.
+*/
+template<typename Lines, typename BeforeSpan> double differenceSpans(
+        const geometrize::Bitmap& target,
+        const BeforeSpan& beforeSpan,
+        const geometrize::Bitmap& after,
+        const double score,
+        const Lines& lines)
+{
+    const std::uint64_t rgbaCount{static_cast<std::uint64_t>(target.getWidth()) * target.getHeight() * 4U};
+    std::uint64_t total{static_cast<std::uint64_t>((score * 255.0) * (score * 255.0) * rgbaCount)};
+    geometrize::forEachSpan(lines, [&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        const std::uint8_t* const t{target.span(y, x1, x2)};
+        const std::uint8_t* const b{beforeSpan(y, x1, x2)};
+        const std::uint8_t* const a{after.span(y, x1, x2)};
+        const std::size_t spanSize{static_cast<std::size_t>(x2 - x1 + 1) * 4U};
+        for(std::size_t i = 0; i < spanSize; i += 4U) {
+            const std::int32_t dtbr{static_cast<std::int32_t>(t[i]) - static_cast<std::int32_t>(b[i])};
+            const std::int32_t dtbg{static_cast<std::int32_t>(t[i + 1U]) - static_cast<std::int32_t>(b[i + 1U])};
+            const std::int32_t dtbb{static_cast<std::int32_t>(t[i + 2U]) - static_cast<std::int32_t>(b[i + 2U])};
+            const std::int32_t dtba{static_cast<std::int32_t>(t[i + 3U]) - static_cast<std::int32_t>(b[i + 3U])};
+
+            const std::int32_t dtar{static_cast<std::int32_t>(t[i]) - static_cast<std::int32_t>(a[i])};
+            const std::int32_t dtag{static_cast<std::int32_t>(t[i + 1U]) - static_cast<std::int32_t>(a[i + 1U])};
+            const std::int32_t dtab{static_cast<std::int32_t>(t[i + 2U]) - static_cast<std::int32_t>(a[i + 2U])};
+            const std::int32_t dtaa{static_cast<std::int32_t>(t[i + 3U]) - static_cast<std::int32_t>(a[i + 3U])};
+
+            total -= static_cast<std::uint64_t>(dtbr * dtbr + dtbg * dtbg + dtbb * dtbb + dtba * dtba);
+            total += static_cast<std::uint64_t>(dtar * dtar + dtag * dtag + dtab * dtab + dtaa * dtaa);
+        }
+    });
+
+    const double result{std::sqrt(static_cast<double>(total) / static_cast<double>(rgbaCount)) / 255.0};
+    return result;
+}
+
+/**
+* @brief differenceBlended Calculates the root-mean-square error between the target and the current bitmap with the scanlines blended onto it in the given color.
+* The blended pixels are calculated on the fly from the current bitmap rather than drawn into a buffer, so no buffer is drawn to or restored.
+* Gives exactly the same results as drawing the scanlines into a copy of the current bitmap and calling differencePartial, as the default energy function does.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param lines The scanlines.
+* @param color The color of the scanlines.
+* @param lastScore The root-mean-square error between the target and current bitmaps.
+* @return The root-mean-square error with the scanlines blended onto the current bitmap.
+*/
+double differenceBlended(
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        const std::vector<geometrize::Scanline>& lines,
+        const geometrize::rgba color,
+        const double lastScore)
+{
+    // The alpha-premultiplied 16-bit color that drawLines would blend with
+    const std::uint32_t m{UINT16_MAX};
+    const std::uint32_t sr{((color.r | (static_cast<std::uint32_t>(color.r) << 8)) * color.a) / UINT8_MAX};
+    const std::uint32_t sg{((color.g | (static_cast<std::uint32_t>(color.g) << 8)) * color.a) / UINT8_MAX};
+    const std::uint32_t sb{((color.b | (static_cast<std::uint32_t>(color.b) << 8)) * color.a) / UINT8_MAX};
+    const std::uint32_t sa{color.a | (static_cast<std::uint32_t>(color.a) << 8)};
+    const std::uint32_t aa{(m - sa) * 257U};
+
+    // Accumulate the change in squared error under the shape, wrapping the same way as differencePartial does
+    std::uint64_t change{0};
+    for(const geometrize::Scanline& line : lines) {
+        const std::uint8_t* t{target.span(line.y, line.x1, line.x2)};
+        const std::uint8_t* c{current.span(line.y, line.x1, line.x2)};
+        for(std::int32_t x = line.x1; x <= line.x2; x++, t += 4, c += 4) {
+            const std::int32_t ar{static_cast<std::uint8_t>(((c[0] * aa + sr * m) / m) >> 8)};
+            const std::int32_t ag{static_cast<std::uint8_t>(((c[1] * aa + sg * m) / m) >> 8)};
+            const std::int32_t ab{static_cast<std::uint8_t>(((c[2] * aa + sb * m) / m) >> 8)};
+            const std::int32_t aalpha{static_cast<std::uint8_t>(((c[3] * aa + sa * m) / m) >> 8)};
+
+            const std::int32_t dtbr{t[0] - c[0]};
+            const std::int32_t dtbg{t[1] - c[1]};
+            const std::int32_t dtbb{t[2] - c[2]};
+            const std::int32_t dtba{t[3] - c[3]};
+
+            const std::int32_t dtar{t[0] - ar};
+            const std::int32_t dtag{t[1] - ag};
+            const std::int32_t dtab{t[2] - ab};
+            const std::int32_t dtaa{t[3] - aalpha};
+
+            change -= static_cast<std::uint64_t>(dtbr * dtbr + dtbg * dtbg + dtbb * dtbb + dtba * dtba);
+            change += static_cast<std::uint64_t>(dtar * dtar + dtag * dtag + dtab * dtab + dtaa * dtaa);
+        }
+    }
+
+    const std::uint64_t rgbaCount{static_cast<std::uint64_t>(target.getWidth()) * target.getHeight() * 4U};
+    const std::uint64_t total{static_cast<std::uint64_t>((lastScore * 255.0) * (lastScore * 255.0) * rgbaCount)};
+    return std::sqrt(static_cast<double>(total + change) / static_cast<double>(rgbaCount)) / 255.0;
+}
+
+/**
+* @brief evaluateState Calculates the energy of the given state, caching its scanlines and, for the default energy function, its color in the state.
+* @param state The state to evaluate.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param buffer The buffer bitmap.
+* @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
+* @return The energy of the state.
+*/
+double evaluateState(
+        geometrize::State& state,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const geometrize::core::EnergyFunction& customEnergyFunction)
+{
+    const std::vector<geometrize::Scanline>& lines{state.rasterize()};
+    if(customEnergyFunction) {
+        return customEnergyFunction(lines, state.m_alpha, target, current, buffer, lastScore);
+    }
+
+    // Same as the default energy function, but keeps hold of the color so it needn't be calculated again if the state is chosen, and needs no buffer
+    state.m_color = geometrize::core::computeColor(target, current, lines, state.m_alpha);
+    state.m_hasColor = true;
+    return ::differenceBlended(target, current, lines, state.m_color, lastScore);
+}
+
 /**
 * @brief hillClimb Hill climbing optimization algorithm, attempts to minimize energy (the error/difference).
 * @param state The state to optimize.
@@ -26,6 +217,7 @@ namespace
 * @param current The current bitmap.
 * @param buffer The buffer bitmap.
 * @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
 * @return The best state found from hillclimbing.
 */
 geometrize::State hillClimb(
@@ -35,7 +227,7 @@ geometrize::State hillClimb(
         const geometrize::Bitmap& current,
         geometrize::Bitmap& buffer,
         const double lastScore,
-        const geometrize::core::EnergyFunction& energyFunction)
+        const geometrize::core::EnergyFunction& customEnergyFunction)
 {
     geometrize::State s(state);
     geometrize::State bestState(state);
@@ -43,11 +235,11 @@ geometrize::State hillClimb(
 
     std::uint32_t age{0};
     while(age < maxAge) {
-        const geometrize::State undo{s.mutate()};
-        s.m_score = energyFunction(s.m_shape->rasterize(*s.m_shape), s.m_alpha, target, current, buffer, lastScore);
+        geometrize::StateUndo undo{s.mutate()};
+        s.m_score = evaluateState(s, target, current, buffer, lastScore, customEnergyFunction);
         const double energy = s.m_score;
         if(energy >= bestEnergy) {
-            s = undo;
+            s.revert(undo);
         } else {
             bestEnergy = energy;
             bestState = s;
@@ -68,6 +260,7 @@ geometrize::State hillClimb(
 * @param current The current bitmap.
 * @param buffer The buffer bitmap.
 * @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
 * @return The best random state i.e. the one with the lowest energy.
 */
 geometrize::State bestRandomState(
@@ -78,25 +271,672 @@ geometrize::State bestRandomState(
         const geometrize::Bitmap& current,
         geometrize::Bitmap& buffer,
         const double lastScore,
-        const geometrize::core::EnergyFunction& energyFunction)
+        const geometrize::core::EnergyFunction& customEnergyFunction)
 {
     geometrize::State bestState(shapeCreator(), alpha);
-    bestState.m_score = energyFunction(bestState.m_shape->rasterize(*bestState.m_shape), bestState.m_alpha, target, current, buffer, lastScore);
+    bestState.m_score = evaluateState(bestState, target, current, buffer, lastScore, customEnergyFunction);
     double bestEnergy = bestState.m_score;
 
     for(std::uint32_t i = 0; i <= n; i++) {
         geometrize::State state(shapeCreator(), alpha);
-        state.m_score = energyFunction(state.m_shape->rasterize(*state.m_shape), state.m_alpha, target, current, buffer, lastScore);
+        state.m_score = evaluateState(state, target, current, buffer, lastScore, customEnergyFunction);
         const double energy = state.m_score;
         if(i == 0 || energy < bestEnergy) {
             bestEnergy = energy;
+            bestState = std::move(state);
+        }
+    }
+
+    return bestState;
+}
+
+/**
+* @brief The ValueState struct is the trivially copyable counterpart of State used when optimizing shape values, so copying and restoring states does not allocate.
+*/
+struct ValueState
+{
+    double m_score; ///< The score of the state, a measure of the improvement applying the state to the current bitmap will have.
+    std::uint8_t m_alpha; ///< The alpha of the shape.
+    geometrize::ShapeValue m_shape; ///< The parameters of the shape.
+    geometrize::rgba m_color; ///< The color calculated for the scanlines of the shape, only valid if m_hasColor is set.
+    bool m_hasColor; ///< Whether the color for the scanlines of the shape is cached in m_color.
+};
+
+/**
+* @brief The ValueArea struct holds the area that shape values are set up, mutated and rasterized within.
+*/
+struct ValueArea
+{
+    std::int32_t xMin; ///< The minimum x coordinate.
+    std::int32_t yMin; ///< The minimum y coordinate.
+    std::int32_t xMax; ///< The maximum x coordinate (exclusive).
+    std::int32_t yMax; ///< The maximum y coordinate (exclusive).
+};
+
+/**
+* @brief The PlanarImages struct holds planar copies of the target and current bitmaps, if the caller keeps them, for the planar scoring kernel.
+*/
+struct PlanarImages
+{
+    const geometrize::PlanarBitmap* target; ///< The planar copy of the target bitmap, or null if there is none.
+    const geometrize::PlanarBitmap* current; ///< The planar copy of the current bitmap, or null if there is none.
+};
+
+/**
+* @brief blendChannel Blends one channel of a pixel with the alpha-premultiplied 16-bit channel of a color, the same way drawLines does.
+*/
+inline std::int32_t blendChannel(const std::uint32_t channel, const std::uint32_t premultiplied, const std::uint32_t inverseAlpha)
+{
+    const std::uint32_t m{UINT16_MAX};
+    return static_cast<std::uint8_t>(((channel * inverseAlpha + premultiplied * m) / m) >> 8);
+}
+
+/**
+* @brief sumChannel Sums the blended values of one channel over a run of pixels, as computeColor does.
+* Stride is the distance between the values of the channel, 1 on planar bitmaps and 4 on interleaved ones.
+*/
+template<std::size_t Stride> inline std::int64_t sumChannel(const std::uint8_t* const t, const std::uint8_t* const c, const std::int32_t count, const std::int32_t a)
+{
+    std::int64_t total{0};
+    for(std::int32_t x = 0; x < count; x++) {
+        total += static_cast<std::int64_t>((t[x * Stride] - c[x * Stride]) * a + c[x * Stride] * 257);
+    }
+    return total;
+}
+
+/**
+* @brief differenceChannel Sums the change in squared error of one channel over a run of pixels when the color is blended onto it, wrapping as differencePartial does.
+* Stride is the distance between the values of the channel, 1 on planar bitmaps and 4 on interleaved ones.
+*/
+template<std::size_t Stride> inline std::uint64_t differenceChannel(const std::uint8_t* const t, const std::uint8_t* const c, const std::int32_t count, const std::uint32_t premultiplied, const std::uint32_t inverseAlpha)
+{
+    std::uint64_t total{0};
+    for(std::int32_t x = 0; x < count; x++) {
+        const std::int32_t before{t[x * Stride] - c[x * Stride]};
+        const std::int32_t after{t[x * Stride] - blendChannel(c[x * Stride], premultiplied, inverseAlpha)};
+        total += static_cast<std::uint64_t>(after * after - before * before);
+    }
+    return total;
+}
+
+/**
+* @brief channelRow Gets a pointer to the first value of one channel on a row of a planar bitmap.
+*/
+inline const std::uint8_t* channelRow(const geometrize::PlanarBitmap& image, const std::size_t channel, const std::int32_t y)
+{
+    return image.getRow(channel, static_cast<std::uint32_t>(y));
+}
+
+/**
+* @brief channelRow Gets a pointer to the first value of one channel on a row of an interleaved bitmap.
+*/
+inline const std::uint8_t* channelRow(const geometrize::Bitmap& image, const std::size_t channel, const std::int32_t y)
+{
+    return image.rowPtr(static_cast<std::uint32_t>(y)) + channel;
+}
+
+/**
+* @brief averageColor Works out the color of a shape from the sums of its blended channels, as computeColor does.
+*/
+geometrize::rgba averageColor(const std::int64_t* const totals, const std::int64_t count, const std::uint8_t alpha)
+{
+    if(count == 0) {
+        return geometrize::rgba{0, 0, 0, 0};
+    }
+    std::uint8_t rgb[3]{};
+    for(std::size_t k = 0; k < 3U; k++) {
+        const std::int32_t v{static_cast<std::int32_t>(totals[k] / count) >> 8};
+        rgb[k] = static_cast<std::uint8_t>(geometrize::commonutil::clamp(v, INT32_C(0), INT32_C(255)));
+    }
+    return geometrize::rgba{rgb[0], rgb[1], rgb[2], alpha};
+}
+
+/**
+* @brief The BlendColor struct holds a color in the alpha-premultiplied 16-bit form that drawLines blends with.
+*/
+struct BlendColor
+{
+    explicit BlendColor(const geometrize::rgba color) :
+        premultiplied{
+            ((color.r | (static_cast<std::uint32_t>(color.r) << 8)) * color.a) / UINT8_MAX,
+            ((color.g | (static_cast<std::uint32_t>(color.g) << 8)) * color.a) / UINT8_MAX,
+            ((color.b | (static_cast<std::uint32_t>(color.b) << 8)) * color.a) / UINT8_MAX,
+            color.a | (static_cast<std::uint32_t>(color.a) << 8)},
+        inverseAlpha{(UINT16_MAX - premultiplied[3]) * 257U}
+    {}
+
+    std::uint32_t premultiplied[4]; ///< The premultiplied red, green, blue and alpha channels.
+    std::uint32_t inverseAlpha; ///< The factor the channels of the pixels blended onto are scaled by.
+};
+
+/**
+* @brief scoreWithChange Calculates the root-mean-square error after a change in the squared error, from the error before it, as differencePartial does.
+*/
+double scoreWithChange(const double lastScore, const std::uint64_t change, const std::uint32_t width, const std::uint32_t height)
+{
+    const std::uint64_t rgbaCount{static_cast<std::uint64_t>(width) * height * 4U};
+    const std::uint64_t total{static_cast<std::uint64_t>((lastScore * 255.0) * (lastScore * 255.0) * rgbaCount)};
+    return std::sqrt(static_cast<double>(total + change) / static_cast<double>(rgbaCount)) / 255.0;
+}
+
+/**
+* @brief evaluatePlanarLines Calculates the energy of the given value state from its scanlines using the default energy function, working on planar
+* copies of the target and current bitmaps. Each channel is summed in its own pass over a run of pixels, and the blended pixels are calculated on the fly
+* rather than drawn into a buffer. Gives exactly the same results as the default energy function. Caches the color of the state.
+* @param state The state to evaluate.
+* @param planar The planar copies of the target and current bitmaps.
+* @param lastScore The last score.
+* @param lines The scanlines of the shape.
+* @return The energy of the state.
+*/
+double evaluatePlanarLines(ValueState& state, const PlanarImages& planar, const double lastScore, const std::vector<geometrize::Scanline>& lines)
+{
+    const geometrize::PlanarBitmap& target{*planar.target};
+    const geometrize::PlanarBitmap& current{*planar.current};
+    assert(target.hasAlpha() == current.hasAlpha());
+    const std::size_t channels{target.hasAlpha() ? 4U : 3U};
+
+    // Work out the color as computeColor does
+    const std::int32_t a{static_cast<std::int32_t>(257.0f * 255.0f / static_cast<float>(state.m_alpha))};
+    std::int64_t totals[3]{0, 0, 0};
+    std::int64_t count{0};
+    for(const geometrize::Scanline& line : lines) {
+        const std::int32_t length{line.x2 - line.x1 + 1};
+        for(std::size_t k = 0; k < 3U; k++) {
+            totals[k] += sumChannel<1>(target.getRow(k, line.y) + line.x1, current.getRow(k, line.y) + line.x1, length, a);
+        }
+        count += length;
+    }
+    state.m_color = averageColor(totals, count, state.m_alpha);
+    state.m_hasColor = true;
+
+    // Accumulate the change in squared error, with the color blended the same way as drawLines does
+    const BlendColor blend{state.m_color};
+    std::uint64_t change{0};
+    for(const geometrize::Scanline& line : lines) {
+        const std::int32_t length{line.x2 - line.x1 + 1};
+        for(std::size_t k = 0; k < channels; k++) {
+            change += differenceChannel<1>(target.getRow(k, line.y) + line.x1, current.getRow(k, line.y) + line.x1, length, blend.premultiplied[k], blend.inverseAlpha);
+        }
+    }
+    return scoreWithChange(lastScore, change, target.getWidth(), target.getHeight());
+}
+
+/**
+* @brief channelOf Gets the row of one channel from the rows given by channelRow. The channels of an interleaved bitmap (Stride 4) are
+* taken from the first row pointer, so the compiler can see that they are next to each other.
+*/
+template<std::size_t Stride> inline const std::uint8_t* channelOf(const std::uint8_t* const* const rows, const std::size_t channel)
+{
+    return Stride == 4 ? rows[0] + channel : rows[channel];
+}
+
+/**
+* @brief sumSpan Sums the blended red, green and blue values over a span of pixels, as computeColor does, reading all three channels in one pass.
+* Stride is the distance between the values of a channel, 1 on planar bitmaps and 4 on interleaved ones.
+*/
+template<std::size_t Stride> inline void sumSpan(const std::uint8_t* const* const t, const std::uint8_t* const* const c, const std::size_t offset, const std::int32_t count, const std::int32_t a, std::int64_t* const totals)
+{
+    const std::uint8_t* const tr{channelOf<Stride>(t, 0) + offset};
+    const std::uint8_t* const tg{channelOf<Stride>(t, 1) + offset};
+    const std::uint8_t* const tb{channelOf<Stride>(t, 2) + offset};
+    const std::uint8_t* const cr{channelOf<Stride>(c, 0) + offset};
+    const std::uint8_t* const cg{channelOf<Stride>(c, 1) + offset};
+    const std::uint8_t* const cb{channelOf<Stride>(c, 2) + offset};
+    std::int64_t r{0};
+    std::int64_t g{0};
+    std::int64_t b{0};
+    for(std::int32_t x = 0; x < count; x++) {
+        const std::size_t i{static_cast<std::size_t>(x) * Stride};
+        r += static_cast<std::int64_t>((tr[i] - cr[i]) * a + cr[i] * 257);
+        g += static_cast<std::int64_t>((tg[i] - cg[i]) * a + cg[i] * 257);
+        b += static_cast<std::int64_t>((tb[i] - cb[i]) * a + cb[i] * 257);
+    }
+    totals[0] += r;
+    totals[1] += g;
+    totals[2] += b;
+}
+
+/**
+* @brief differenceSpan Sums the change in squared error over a span of pixels when the color is blended onto it, reading every channel in one pass.
+* Stride is the distance between the values of a channel, 1 on planar bitmaps and 4 on interleaved ones. Channels is 3 if the alpha channel is left out.
+*/
+template<std::size_t Stride, std::size_t Channels> inline std::uint64_t differenceSpan(const std::uint8_t* const* const t, const std::uint8_t* const* const c, const std::size_t offset, const std::int32_t count, const BlendColor& blend)
+{
+    std::uint64_t total{0};
+    for(std::int32_t x = 0; x < count; x++) {
+        const std::size_t i{offset + static_cast<std::size_t>(x) * Stride};
+        for(std::size_t k = 0; k < Channels; k++) {
+            const std::int32_t tk{channelOf<Stride>(t, k)[i]};
+            const std::int32_t ck{channelOf<Stride>(c, k)[i]};
+            const std::int32_t before{tk - ck};
+            const std::int32_t after{tk - blendChannel(static_cast<std::uint32_t>(ck), blend.premultiplied[k], blend.inverseAlpha)};
+            total += static_cast<std::uint64_t>(after * after - before * before);
+        }
+    }
+    return total;
+}
+
+/**
+* @brief scoreSpanBatch Calculates the energies of a batch of value states from their spans using the default energy function, caching their colors in the states.
+* The rows of the batch are swept once to sum the colors under every shape on each row, and once more to sum the change in error for every shape with the colors found,
+* so each row of the target and current bitmaps is read for all of the shapes on it together. Works on planar bitmaps (Stride 1) or interleaved ones (Stride 4).
+* @param states The states to evaluate.
+* @param spans The spans of the states.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param lastScore The last score.
+*/
+template<std::size_t Stride, std::size_t Channels, typename Image> void scoreSpanBatch(
+        ValueState* const states,
+        const geometrize::SpanBatch& spans,
+        const Image& target,
+        const Image& current,
+        const double lastScore)
+{
+    const std::size_t count{spans.shapeCount};
+    const std::size_t maxShapes{geometrize::SpanBatch::MAX_SHAPES};
+
+    // Sum the blended colors under every shape, a row at a time
+    std::int32_t a[maxShapes]{};
+    for(std::size_t k = 0; k < count; k++) {
+        a[k] = static_cast<std::int32_t>(257.0f * 255.0f / static_cast<float>(states[k].m_alpha));
+    }
+    std::int64_t totals[maxShapes][3]{};
+    std::int64_t pixelCounts[maxShapes]{};
+    const std::int32_t* x1s{spans.x1.data()};
+    const std::int32_t* x2s{spans.x2.data()};
+    for(std::int32_t y = spans.yMin; y <= spans.yMax; y++, x1s += count, x2s += count) {
+        const std::uint8_t* const t[3]{channelRow(target, 0, y), channelRow(target, 1, y), channelRow(target, 2, y)};
+        const std::uint8_t* const c[3]{channelRow(current, 0, y), channelRow(current, 1, y), channelRow(current, 2, y)};
+        for(std::size_t k = 0; k < count; k++) {
+            const std::int32_t length{x2s[k] - x1s[k] + 1};
+            if(length > 0) {
+                sumSpan<Stride>(t, c, static_cast<std::size_t>(x1s[k]) * Stride, length, a[k], totals[k]);
+                pixelCounts[k] += length;
+            }
+        }
+    }
+
+    std::vector<BlendColor> blends;
+    for(std::size_t k = 0; k < count; k++) {
+        states[k].m_color = averageColor(totals[k], pixelCounts[k], states[k].m_alpha);
+        states[k].m_hasColor = true;
+        blends.emplace_back(states[k].m_color);
+    }
+
+    // Accumulate the change in squared error under every shape with its color blended in, a row at a time
+    std::uint64_t change[maxShapes]{};
+    x1s = spans.x1.data();
+    x2s = spans.x2.data();
+    for(std::int32_t y = spans.yMin; y <= spans.yMax; y++, x1s += count, x2s += count) {
+        const std::uint8_t* t[4]{};
+        const std::uint8_t* c[4]{};
+        for(std::size_t i = 0; i < Channels; i++) {
+            t[i] = channelRow(target, i, y);
+            c[i] = channelRow(current, i, y);
+        }
+        for(std::size_t k = 0; k < count; k++) {
+            const std::int32_t length{x2s[k] - x1s[k] + 1};
+            if(length > 0) {
+                change[k] += differenceSpan<Stride, Channels>(t, c, static_cast<std::size_t>(x1s[k]) * Stride, length, blends[k]);
+            }
+        }
+    }
+
+    for(std::size_t k = 0; k < count; k++) {
+        states[k].m_score = scoreWithChange(lastScore, change[k], target.getWidth(), target.getHeight());
+    }
+}
+
+/**
+* @brief evaluateValueLines Calculates the energy of the given value state from its scanlines, caching its color in the state for the default energy function.
+* @param state The state to evaluate.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param buffer The buffer bitmap.
+* @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
+* @param planar Planar copies of the target and current bitmaps, used for the default energy calculation if they are given.
+* @param lines The scanlines of the shape.
+* @return The energy of the state.
+*/
+double evaluateValueLines(
+        ValueState& state,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const geometrize::core::EnergyFunction& customEnergyFunction,
+        const PlanarImages& planar,
+        const std::vector<geometrize::Scanline>& lines)
+{
+    if(customEnergyFunction) {
+        state.m_hasColor = false;
+        return customEnergyFunction(lines, state.m_alpha, target, current, buffer, lastScore);
+    }
+
+    if(planar.target && planar.current) {
+        return evaluatePlanarLines(state, planar, lastScore, lines);
+    }
+
+    state.m_color = geometrize::core::computeColor(target, current, lines, state.m_alpha);
+    state.m_hasColor = true;
+    return ::differenceBlended(target, current, lines, state.m_color, lastScore);
+}
+
+/**
+* @brief evaluateValueState Calculates the energy of the given value state, caching its color in the state for the default energy function.
+* @param state The state to evaluate.
+* @param area The area the shape is rasterized within.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param buffer The buffer bitmap.
+* @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
+* @param planar Planar copies of the target and current bitmaps, used for the default energy calculation if they are given.
+* @param lines Receives the scanlines of the shape.
+* @return The energy of the state.
+*/
+template<typename T> double evaluateValueState(
+        ValueState& state,
+        const ValueArea& area,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const geometrize::core::EnergyFunction& customEnergyFunction,
+        const PlanarImages& planar,
+        std::vector<geometrize::Scanline>& lines)
+{
+    lines = geometrize::rasterize(geometrize::ShapeValueTraits<T>::get(state.m_shape), area.xMin, area.yMin, area.xMax, area.yMax);
+    return evaluateValueLines(state, target, current, buffer, lastScore, customEnergyFunction, planar, lines);
+}
+
+/**
+* @brief rasterizeValue Rasterizes a shape value for the hill climber. Triangles and polylines are rasterized through an edge span cache, so
+* only the edges next to the vertex that was moved are walked again. Commit the cache when the shape is kept.
+* @param cache The edge span cache holding the edges of the last shape kept.
+* @param shape The shape to rasterize.
+* @param area The area the shape is rasterized within.
+* @param lines Receives the scanlines of the shape.
+*/
+template<typename T> void rasterizeValue(geometrize::EdgeSpanCache& cache, const T& shape, const ValueArea& area, std::vector<geometrize::Scanline>& lines)
+{
+    static_cast<void>(cache);
+    lines = geometrize::rasterize(shape, area.xMin, area.yMin, area.xMax, area.yMax);
+}
+
+void rasterizeValue(geometrize::EdgeSpanCache& cache, const geometrize::TriangleValue& shape, const ValueArea& area, std::vector<geometrize::Scanline>& lines)
+{
+    cache.rasterize(shape, area.xMin, area.yMin, area.xMax, area.yMax, lines);
+}
+
+void rasterizeValue(geometrize::EdgeSpanCache& cache, const geometrize::PolylineValue& shape, const ValueArea& area, std::vector<geometrize::Scanline>& lines)
+{
+    cache.rasterize(shape, area.xMin, area.yMin, area.xMax, area.yMax, lines);
+}
+
+/**
+* @brief createValueState Creates a value state holding a randomly set up shape of one of the given types.
+* @param types The types of shape to choose from.
+* @param area The area the shape is set up within.
+* @param alpha The alpha of the shape.
+* @return The new state.
+*/
+template<typename T> ValueState createValueState(const geometrize::ShapeTypes types, const ValueArea& area, const std::uint8_t alpha)
+{
+    ValueState state{-1.0, alpha, geometrize::createShapeValue(geometrize::randomShapeTypeOf(types)), geometrize::rgba{0, 0, 0, 0}, false};
+    geometrize::setup(geometrize::ShapeValueTraits<T>::get(state.m_shape), area.xMin, area.yMin, area.xMax, area.yMax);
+    return state;
+}
+
+/**
+* @brief hillClimbValue Hill climbing optimization algorithm for value states, attempts to minimize energy (the error/difference).
+* @param state The state to optimize.
+* @param area The area the shape is mutated and rasterized within.
+* @param maxAge The maximum age.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param buffer The buffer bitmap.
+* @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
+* @param planar Planar copies of the target and current bitmaps, used for the default energy calculation if they are given.
+* @param bestLines Holds the scanlines of the state on entry, receives the scanlines of the best state found.
+* @return The best state found from hillclimbing.
+*/
+template<typename T> ValueState hillClimbValue(
+        const ValueState& state,
+        const ValueArea& area,
+        const std::uint32_t maxAge,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const geometrize::core::EnergyFunction& customEnergyFunction,
+        const PlanarImages& planar,
+        std::vector<geometrize::Scanline>& bestLines)
+{
+    ValueState s{state};
+    ValueState bestState{state};
+    std::vector<geometrize::Scanline> lines;
+
+    // The shape being mutated is always the best one found so far, so that is the one kept in the edge span cache
+    geometrize::EdgeSpanCache cache;
+    rasterizeValue(cache, geometrize::ShapeValueTraits<T>::get(s.m_shape), area, lines);
+    cache.commit();
+
+    std::uint32_t age{0};
+    while(age < maxAge) {
+        const ValueState undo{s};
+        geometrize::mutate(geometrize::ShapeValueTraits<T>::get(s.m_shape), area.xMin, area.yMin, area.xMax, area.yMax);
+        rasterizeValue(cache, geometrize::ShapeValueTraits<T>::get(s.m_shape), area, lines);
+        s.m_score = evaluateValueLines(s, target, current, buffer, lastScore, customEnergyFunction, planar, lines);
+        if(s.m_score >= bestState.m_score) {
+            s = undo;
+        } else {
+            bestState = s;
+            cache.commit();
+            std::swap(bestLines, lines);
+            age = -1;
+        }
+        age++;
+    }
+
+    return bestState;
+}
+
+/**
+* @brief evaluateValueStates Calculates the energies of a batch of value states using the default energy function, caching their colors in the states.
+* Circles, ellipses and rectangles are rasterized together and scored in one sweep down the rows of the batch with scoreSpanBatch,
+* other shapes are scored one at a time. Works on the planar copies of the bitmaps if they are given. Gives exactly the same results as evaluateValueState.
+* @param states The states to evaluate.
+* @param count The number of states, at most SpanBatch::MAX_SHAPES.
+* @param area The area the shapes are rasterized within.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param lastScore The last score.
+* @param planar Planar copies of the target and current bitmaps, used if they are given.
+* @param spans Scratch space for the spans of the batch.
+* @param lines Scratch space for the scanlines of shapes scored one at a time.
+*/
+template<typename T> void evaluateValueStates(
+        ValueState* const states,
+        const std::size_t count,
+        const ValueArea& area,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        const double lastScore,
+        const PlanarImages& planar,
+        geometrize::SpanBatch& spans,
+        std::vector<geometrize::Scanline>& lines)
+{
+    if constexpr(std::is_same<T, geometrize::CircleValue>::value || std::is_same<T, geometrize::EllipseValue>::value || std::is_same<T, geometrize::RectangleValue>::value) {
+        // Gather the parameters of the shapes into an array to rasterize them together
+        T shapes[geometrize::SpanBatch::MAX_SHAPES];
+        for(std::size_t k = 0; k < count; k++) {
+            shapes[k] = geometrize::ShapeValueTraits<T>::get(states[k].m_shape);
+        }
+        geometrize::rasterize(shapes, count, area.xMin, area.yMin, area.xMax, area.yMax, spans);
+
+        if(!planar.target || !planar.current) {
+            scoreSpanBatch<4, 4>(states, spans, target, current, lastScore);
+        } else if(planar.target->hasAlpha()) {
+            scoreSpanBatch<1, 4>(states, spans, *planar.target, *planar.current, lastScore);
+        } else {
+            scoreSpanBatch<1, 3>(states, spans, *planar.target, *planar.current, lastScore);
+        }
+    } else {
+        static_cast<void>(spans);
+        geometrize::Bitmap unused{0U, 0U, std::vector<std::uint8_t>{}};
+        for(std::size_t k = 0; k < count; k++) {
+            states[k].m_score = evaluateValueState<T>(states[k], area, target, current, unused, lastScore, nullptr, planar, lines);
+        }
+    }
+}
+
+/**
+* @brief bestRandomValueState Gets the best value state using a random algorithm.
+* With the default energy function, the states are created and evaluated in batches with evaluateValueStates.
+* @param types The types of shape to choose from.
+* @param area The area the shapes are set up and rasterized within.
+* @param alpha The opacity of the shape.
+* @param n The number of states to try.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param buffer The buffer bitmap.
+* @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
+* @param planar Planar copies of the target and current bitmaps, used for the default energy calculation if they are given.
+* @param bestLines Receives the scanlines of the best state.
+* @return The best random state i.e. the one with the lowest energy.
+*/
+template<typename T> ValueState bestRandomValueState(
+        const geometrize::ShapeTypes types,
+        const ValueArea& area,
+        const std::uint8_t alpha,
+        const std::uint32_t n,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const geometrize::core::EnergyFunction& customEnergyFunction,
+        const PlanarImages& planar,
+        std::vector<geometrize::Scanline>& bestLines)
+{
+    if(!customEnergyFunction) {
+        // The first state is always replaced by the second one, so it is created (to use the random number generator the same way) but never evaluated
+        static_cast<void>(createValueState<T>(types, area, alpha));
+
+        // Create the states in the same order as when they are evaluated one at a time, then evaluate them in batches of nearby shapes, keeping the first of any equally good states
+        std::vector<ValueState> states;
+        std::vector<std::size_t> order;
+        states.reserve(n + 1U);
+        order.reserve(n + 1U);
+        for(std::uint32_t i = 0; i <= n; i++) {
+            states.push_back(createValueState<T>(types, area, alpha));
+            order.push_back(i);
+        }
+        // Nearby shapes are found by grouping the states by the 64 pixel tile their top left corner lies in, so the shapes in a batch share most of their rows and columns
+        std::vector<std::int64_t> tiles;
+        tiles.reserve(states.size());
+        for(const ValueState& state : states) {
+            const geometrize::BoundingBox bounds{geometrize::getBounds(geometrize::ShapeValueTraits<T>::get(state.m_shape))};
+            tiles.push_back((static_cast<std::int64_t>(bounds.yMin >> 6) << 32) + (bounds.xMin >> 6));
+        }
+        std::stable_sort(order.begin(), order.end(), [&tiles](const std::size_t a, const std::size_t b) {
+            return tiles[a] < tiles[b];
+        });
+
+        ValueState batch[geometrize::SpanBatch::MAX_SHAPES];
+        geometrize::SpanBatch spans;
+        std::vector<geometrize::Scanline> lines;
+        for(std::size_t first = 0; first < order.size(); first += geometrize::SpanBatch::MAX_SHAPES) {
+            const std::size_t count{(std::min)(order.size() - first, geometrize::SpanBatch::MAX_SHAPES)};
+            for(std::size_t k = 0; k < count; k++) {
+                batch[k] = states[order[first + k]];
+            }
+            evaluateValueStates<T>(batch, count, area, target, current, lastScore, planar, spans, lines);
+            for(std::size_t k = 0; k < count; k++) {
+                states[order[first + k]] = batch[k];
+            }
+        }
+
+        const ValueState bestState{*std::min_element(states.begin(), states.end(), [](const ValueState& a, const ValueState& b) {
+            return a.m_score < b.m_score;
+        })};
+        bestLines = geometrize::rasterize(geometrize::ShapeValueTraits<T>::get(bestState.m_shape), area.xMin, area.yMin, area.xMax, area.yMax);
+        return bestState;
+    }
+
+    ValueState bestState{createValueState<T>(types, area, alpha)};
+    bestState.m_score = evaluateValueState<T>(bestState, area, target, current, buffer, lastScore, customEnergyFunction, planar, bestLines);
+    std::vector<geometrize::Scanline> lines;
+
+    for(std::uint32_t i = 0; i <= n; i++) {
+        ValueState state{createValueState<T>(types, area, alpha)};
+        state.m_score = evaluateValueState<T>(state, area, target, current, buffer, lastScore, customEnergyFunction, planar, lines);
+        if(i == 0 || state.m_score < bestState.m_score) {
             bestState = state;
+            std::swap(bestLines, lines);
         }
     }
 
     return bestState;
 }
 
+/**
+* @brief bestValueHillClimbState Gets the best state using a hill climbing algorithm on shape values.
+* Instantiated for each shape value type, so the setup, mutate and rasterize calls go straight to the functions for that type,
+* and for ShapeValue itself, which dispatches on the type held at runtime.
+* @param types The types of shape to use.
+* @param xMin The minimum x coordinate of the shapes created.
+* @param yMin The minimum y coordinate of the shapes created.
+* @param xMax The maximum x coordinate of the shapes created.
+* @param yMax The maximum y coordinate of the shapes created.
+* @param alpha The opacity of the shape.
+* @param n The number of random states to generate.
+* @param age The number of hillclimbing steps.
+* @param target The target bitmap.
+* @param current The current bitmap.
+* @param buffer The buffer bitmap.
+* @param lastScore The last score.
+* @param customEnergyFunction An optional function to calculate the energy (if unspecified the default energy calculation is used).
+* @param planar Planar copies of the target and current bitmaps, used for the default energy calculation if they are given.
+* @return The best state acquired from hill climbing i.e. the one with the lowest energy.
+*/
+template<typename T> geometrize::State bestValueHillClimbState(
+        const geometrize::ShapeTypes types,
+        const std::int32_t xMin,
+        const std::int32_t yMin,
+        const std::int32_t xMax,
+        const std::int32_t yMax,
+        const std::uint32_t alpha,
+        const std::uint32_t n,
+        const std::uint32_t age,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const geometrize::core::EnergyFunction& customEnergyFunction,
+        const PlanarImages& planar)
+{
+    const ValueArea area{xMin, yMin, xMax, yMax};
+    std::vector<geometrize::Scanline> lines;
+    const ValueState randomState{bestRandomValueState<T>(types, area, static_cast<std::uint8_t>(alpha), n, target, current, buffer, lastScore, customEnergyFunction, planar, lines)};
+    const ValueState bestState{hillClimbValue<T>(randomState, area, age, target, current, buffer, lastScore, customEnergyFunction, planar, lines)};
+
+    geometrize::State state;
+    state.m_score = bestState.m_score;
+    state.m_alpha = bestState.m_alpha;
+    state.m_shape = geometrize::toShape(bestState.m_shape, xMin, yMin, xMax, yMax);
+    state.m_lines = std::move(lines);
+    state.m_color = bestState.m_color;
+    state.m_hasLines = true;
+    state.m_hasColor = bestState.m_hasColor;
+    return state;
+}
+
 }
 
 namespace geometrize
@@ -125,50 +965,16 @@ geometrize::rgba computeColor(
         const std::vector<geometrize::Scanline>& lines,
         const std::uint8_t alpha)
 {
-    // Early out to avoid integer divide by 0
-    if(lines.empty()) {
-        return geometrize::rgba{0, 0, 0, 0};
-    }
-
-    std::int64_t totalRed{0};
-    std::int64_t totalGreen{0};
-    std::int64_t totalBlue{0};
-    std::int64_t count{0};
-    const std::int32_t a{static_cast<std::int32_t>(257.0f * 255.0f / static_cast<float>(alpha))};
-
-    // For each scanline
-    for(const geometrize::Scanline& line : lines) {
-        const std::int32_t y{line.y};
-        for(std::int32_t x = line.x1; x <= line.x2; x++) {
-            // Get the overlapping target and current colors
-            const geometrize::rgba t(target.getPixel(x, y));
-            const geometrize::rgba c(current.getPixel(x, y));
-
-            const std::int32_t tr{t.r};
-            const std::int32_t tg{t.g};
-            const std::int32_t tb{t.b};
-            const std::int32_t cr{c.r};
-            const std::int32_t cg{c.g};
-            const std::int32_t cb{c.b};
-
-            // Mix the red, green and blue components, blending by the given alpha value
-            totalRed += static_cast<std::int64_t>((tr - cr) * a + cr * 257);
-            totalGreen += static_cast<std::int64_t>((tg - cg) * a + cg * 257);
-            totalBlue += static_cast<std::int64_t>((tb - cb) * a + cb * 257);
-            count++;
-        }
-    }
-
-    const std::int32_t rr{static_cast<std::int32_t>(totalRed / count) >> 8};
-    const std::int32_t gg{static_cast<std::int32_t>(totalGreen / count) >> 8};
-    const std::int32_t bb{static_cast<std::int32_t>(totalBlue / count) >> 8};
-
-    // Scale totals down to 0-255 range and return average blended color
-    const std::uint8_t r{static_cast<std::uint8_t>(commonutil::clamp(rr, INT32_C(0), INT32_C(255)))};
-    const std::uint8_t g{static_cast<std::uint8_t>(commonutil::clamp(gg, INT32_C(0), INT32_C(255)))};
-    const std::uint8_t b{static_cast<std::uint8_t>(commonutil::clamp(bb, INT32_C(0), INT32_C(255)))};
+    return ::computeSpanColor(target, current, lines, alpha);
+}
 
-    return geometrize::rgba{r, g, b, alpha};
+geometrize::rgba computeColor(
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        const geometrize::ScanlineSet& lines,
+        const std::uint8_t alpha)
+{
+    return ::computeSpanColor(target, current, lines, alpha);
 }
 
 double differenceFull(const geometrize::Bitmap& first, const geometrize::Bitmap& second)
@@ -180,16 +986,15 @@ double differenceFull(const geometrize::Bitmap& first, const geometrize::Bitmap&
     const std::size_t height{first.getHeight()};
     std::uint64_t total{0};
 
-    for(std::size_t y = 0; y < height; y++) {
-        for(std::size_t x = 0; x < width; x++) {
-            const geometrize::rgba f(first.getPixel(x, y));
-            const geometrize::rgba s(second.getPixel(x, y));
-
-            const std::int32_t dr = {static_cast<std::int32_t>(f.r) - static_cast<std::int32_t>(s.r)};
-            const std::int32_t dg = {static_cast<std::int32_t>(f.g) - static_cast<std::int32_t>(s.g)};
-            const std::int32_t db = {static_cast<std::int32_t>(f.b) - static_cast<std::int32_t>(s.b)};
-            const std::int32_t da = {static_cast<std::int32_t>(f.a) - static_cast<std::int32_t>(s.a)};
-            total += (dr * dr + dg * dg + db * db + da * da);
+    for(std::uint32_t y = 0; y < height; y++) {
+        const std::uint8_t* const f{first.rowPtr(y)};
+        const std::uint8_t* const s{second.rowPtr(y)};
+        for(std::size_t i = 0; i < width * 4U; i += 4U) {
+            const std::int32_t dr = {static_cast<std::int32_t>(f[i]) - static_cast<std::int32_t>(s[i])};
+            const std::int32_t dg = {static_cast<std::int32_t>(f[i + 1U]) - static_cast<std::int32_t>(s[i + 1U])};
+            const std::int32_t db = {static_cast<std::int32_t>(f[i + 2U]) - static_cast<std::int32_t>(s[i + 2U])};
+            const std::int32_t da = {static_cast<std::int32_t>(f[i + 3U]) - static_cast<std::int32_t>(s[i + 3U])};
+            total += static_cast<std::uint64_t>(dr * dr + dg * dg + db * db + da * da);
         }
     }
     return std::sqrt(static_cast<double>(total) / (static_cast<double>(width) * static_cast<double>(height) * 4.0)) / 255.0;
@@ -202,32 +1007,36 @@ double differencePartial(
         const double score,
         const std::vector<Scanline>& lines)
 {
-    const std::uint64_t rgbaCount{target.getWidth() * target.getHeight() * 4U};
-    std::uint64_t total{static_cast<std::uint64_t>((score * 255.0) * (score * 255.0) * rgbaCount)};
-    for(const geometrize::Scanline& line : lines) {
-        const std::int32_t y{line.y};
-        for(std::int32_t x = line.x1; x <= line.x2; x++) {
-            const geometrize::rgba t(target.getPixel(x, y));
-            const geometrize::rgba b(before.getPixel(x, y));
-            const geometrize::rgba a(after.getPixel(x, y));
-
-            const std::int32_t dtbr{static_cast<std::int32_t>(t.r) - static_cast<std::int32_t>(b.r)};
-            const std::int32_t dtbg{static_cast<std::int32_t>(t.g) - static_cast<std::int32_t>(b.g)};
-            const std::int32_t dtbb{static_cast<std::int32_t>(t.b) - static_cast<std::int32_t>(b.b)};
-            const std::int32_t dtba{static_cast<std::int32_t>(t.a) - static_cast<std::int32_t>(b.a)};
-
-            const std::int32_t dtar{static_cast<std::int32_t>(t.r) - static_cast<std::int32_t>(a.r)};
-            const std::int32_t dtag{static_cast<std::int32_t>(t.g) - static_cast<std::int32_t>(a.g)};
-            const std::int32_t dtab{static_cast<std::int32_t>(t.b) - static_cast<std::int32_t>(a.b)};
-            const std::int32_t dtaa{static_cast<std::int32_t>(t.a) - static_cast<std::int32_t>(a.a)};
+    return ::differenceSpans(target, [&before](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        return before.span(y, x1, x2);
+    }, after, score, lines);
+}
 
-            total -= static_cast<std::uint64_t>(dtbr * dtbr + dtbg * dtbg + dtbb * dtbb + dtba * dtba);
-            total += static_cast<std::uint64_t>(dtar * dtar + dtag * dtag + dtab * dtab + dtaa * dtaa);
-        }
-    }
+double differencePartial(
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& before,
+        const geometrize::Bitmap& after,
+        const double score,
+        const geometrize::ScanlineSet& lines)
+{
+    return ::differenceSpans(target, [&before](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        return before.span(y, x1, x2);
+    }, after, score, lines);
+}
 
-    const double result{std::sqrt(static_cast<double>(total) / static_cast<double>(rgbaCount)) / 255.0};
-    return result;
+double differencePartial(
+        const geometrize::Bitmap& target,
+        const geometrize::ScanlineUndoBuffer& before,
+        const geometrize::Bitmap& after,
+        const double score)
+{
+    // The saved pixels are packed in the order of the saved scanlines, which is the order the spans are visited in
+    const std::uint8_t* saved{before.getPixels()};
+    return ::differenceSpans(target, [&saved](const std::int32_t, const std::int32_t x1, const std::int32_t x2) {
+        const std::uint8_t* const span{saved};
+        saved += static_cast<std::size_t>(x2 - x1 + 1) * 4U;
+        return span;
+    }, after, score, before.getLines());
 }
 
 geometrize::State bestHillClimbState(
@@ -241,10 +1050,70 @@ geometrize::State bestHillClimbState(
         const double lastScore,
         const EnergyFunction& customEnergyFunction)
 {
-    const EnergyFunction& e = customEnergyFunction ? customEnergyFunction : geometrize::core::defaultEnergyFunction;
+    const geometrize::State state{bestRandomState(shapeCreator, alpha, n, target, current, buffer, lastScore, customEnergyFunction)};
+    return ::hillClimb(state, age, target, current, buffer, lastScore, customEnergyFunction);
+}
+
+geometrize::State bestHillClimbState(
+        const geometrize::ShapeTypes types,
+        const std::int32_t xMin,
+        const std::int32_t yMin,
+        const std::int32_t xMax,
+        const std::int32_t yMax,
+        const std::uint32_t alpha,
+        const std::uint32_t n,
+        const std::uint32_t age,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const EnergyFunction& customEnergyFunction,
+        const geometrize::PlanarBitmap* const planarTarget,
+        const geometrize::PlanarBitmap* const planarCurrent)
+{
+    const ::PlanarImages planar{planarTarget, planarCurrent};
 
-    const geometrize::State state{bestRandomState(shapeCreator, alpha, n, target, current, buffer, lastScore, e)};
-    return ::hillClimb(state, age, target, current, buffer, lastScore, e);
+    // Use a pipeline specialized for the shape type if there is only one type of shape to choose from
+    switch(types) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        return ::bestValueHillClimbState<geometrize::RectangleValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        return ::bestValueHillClimbState<geometrize::RotatedRectangleValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::TRIANGLE:
+        return ::bestValueHillClimbState<geometrize::TriangleValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::ELLIPSE:
+        return ::bestValueHillClimbState<geometrize::EllipseValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        return ::bestValueHillClimbState<geometrize::RotatedEllipseValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::CIRCLE:
+        return ::bestValueHillClimbState<geometrize::CircleValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::LINE:
+        return ::bestValueHillClimbState<geometrize::LineValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        return ::bestValueHillClimbState<geometrize::QuadraticBezierValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    case geometrize::ShapeTypes::POLYLINE:
+        return ::bestValueHillClimbState<geometrize::PolylineValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    default:
+        return ::bestValueHillClimbState<geometrize::ShapeValue>(types, xMin, yMin, xMax, yMax, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction, planar);
+    }
+}
+
+geometrize::State bestHillClimbState(
+        const geometrize::ShapeSlotCreator& shapeCreator,
+        geometrize::ShapeArena& arena,
+        const std::uint32_t alpha,
+        const std::uint32_t n,
+        const std::uint32_t age,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        const double lastScore,
+        const EnergyFunction& customEnergyFunction)
+{
+    const std::function<std::shared_ptr<geometrize::Shape>(void)> arenaShapeCreator{[&shapeCreator, &arena]() {
+        return shapeCreator(arena);
+    }};
+    return bestHillClimbState(arenaShapeCreator, alpha, n, age, target, current, buffer, lastScore, customEnergyFunction);
 }
 
 }
@@ -7,11 +7,16 @@
 
 #include "bitmap/rgba.h"
 #include "rasterizer/scanline.h"
+#include "shape/shapearena.h"
+#include "shape/shapetypes.h"
 #include "state.h"
 
 namespace geometrize
 {
 class Bitmap;
+class PlanarBitmap;
+class ScanlineSet;
+class ScanlineUndoBuffer;
 }
 
 namespace geometrize
@@ -75,6 +80,20 @@ geometrize::rgba computeColor(
         const std::vector<geometrize::Scanline>& lines,
         std::uint8_t alpha);
 
+/**
+ * @brief computeColor Calculates the color of a set of scanlines.
+ * @param target The target image.
+ * @param current The current image.
+ * @param lines The scanline set.
+ * @param alpha The alpha of the scanline.
+ * @return The color of the scanlines.
+ */
+geometrize::rgba computeColor(
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        const geometrize::ScanlineSet& lines,
+        std::uint8_t alpha);
+
 /**
  * @brief differenceFull Calculates the root-mean-square error between two bitmaps.
  * @param first The first bitmap.
@@ -100,6 +119,37 @@ double differencePartial(
         double score,
         const std::vector<Scanline>& lines);
 
+/**
+ * @brief differencePartial Calculates the root-mean-square error between the parts of the two bitmaps within a scanline set, visiting the rows in order.
+ * @param target The target bitmap.
+ * @param before The bitmap before the change.
+ * @param after The bitmap after the change.
+ * @param score The score.
+ * @param lines The scanline set.
+ * @return The difference/error between the two bitmaps, masked by the scanlines.
+ */
+double differencePartial(
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& before,
+        const geometrize::Bitmap& after,
+        double score,
+        const geometrize::ScanlineSet& lines);
+
+/**
+ * @brief differencePartial Calculates the root-mean-square error between the pixels saved in an undo buffer and the same pixels of a bitmap, within the saved scanlines.
+ * Gives the same result as the version that takes the whole bitmap from before the change, without needing a copy of it.
+ * @param target The target bitmap.
+ * @param before The undo buffer holding the pixels under the scanlines from before the change.
+ * @param after The bitmap after the change.
+ * @param score The score.
+ * @return The difference/error between the two bitmaps, masked by the saved scanlines.
+ */
+double differencePartial(
+        const geometrize::Bitmap& target,
+        const geometrize::ScanlineUndoBuffer& before,
+        const geometrize::Bitmap& after,
+        double score);
+
 /**
  * @brief bestHillClimbState Gets the best state using a hill climbing algorithm.
  * @param shapeCreator A function that will create the shapes that will be chosen from.
@@ -108,7 +158,7 @@ double differencePartial(
  * @param age The number of hillclimbing steps.
  * @param target The target bitmap.
  * @param current The current bitmap.
- * @param buffer The buffer bitmap.
+ * @param buffer The buffer bitmap, only passed on to a custom energy function. The default energy calculation does not use it, so it may be empty then.
  * @param lastScore The last score.
  * @param customEnergyFunction An optional function to calculate the energy (if unspecified a default implementation is used).
  * @return The best state acquired from hill climbing i.e. the one with the lowest energy.
@@ -124,6 +174,72 @@ geometrize::State bestHillClimbState(
         double lastScore,
         const EnergyFunction& customEnergyFunction = nullptr);
 
+/**
+ * @brief bestHillClimbState Gets the best state using a hill climbing algorithm, choosing between randomly created shapes of the given types.
+ * The shapes are held as trivially copyable shape values while they are optimized, so no memory is allocated per mutation, and only the final state holds a shape object.
+ * Consumes random numbers in the same order as the shape creator version does with a default shape creator, so gives the same results.
+ * When types names exactly one shape type, a pipeline specialized for that type is used, avoiding per-call dispatch on the shape type.
+ * @param types The types of shape to use.
+ * @param xMin The minimum x coordinate of the shapes created.
+ * @param yMin The minimum y coordinate of the shapes created.
+ * @param xMax The maximum x coordinate of the shapes created.
+ * @param yMax The maximum y coordinate of the shapes created.
+ * @param alpha The opacity of the shape.
+ * @param n The number of random states to generate.
+ * @param age The number of hillclimbing steps.
+ * @param target The target bitmap.
+ * @param current The current bitmap.
+ * @param buffer The buffer bitmap, only passed on to a custom energy function. The default energy calculation does not use it, so it may be empty then.
+ * @param lastScore The last score.
+ * @param customEnergyFunction An optional function to calculate the energy (if unspecified a default implementation is used).
+ * @param planarTarget An optional planar copy of the target bitmap. If given along with planarCurrent, the default energy is calculated on the planar copies while hill climbing.
+ * @param planarCurrent An optional planar copy of the current bitmap, which must match it. Both planar copies must keep their alpha planes, or neither.
+ * @return The best state acquired from hill climbing i.e. the one with the lowest energy.
+ */
+geometrize::State bestHillClimbState(
+        geometrize::ShapeTypes types,
+        std::int32_t xMin,
+        std::int32_t yMin,
+        std::int32_t xMax,
+        std::int32_t yMax,
+        std::uint32_t alpha,
+        std::uint32_t n,
+        std::uint32_t age,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        double lastScore,
+        const EnergyFunction& customEnergyFunction = nullptr,
+        const geometrize::PlanarBitmap* planarTarget = nullptr,
+        const geometrize::PlanarBitmap* planarCurrent = nullptr);
+
+/**
+ * @brief bestHillClimbState Gets the best state using a hill climbing algorithm, taking the random candidate shapes from a shape arena.
+ * Only the candidates alive at once are allocated, the rest reuse the arena slots of rejected candidates.
+ * @param shapeCreator A function that will take the shapes that will be chosen from out of the arena.
+ * @param arena The arena to take shapes from, owned by the calling thread.
+ * @param alpha The opacity of the shape.
+ * @param n The number of random states to generate.
+ * @param age The number of hillclimbing steps.
+ * @param target The target bitmap.
+ * @param current The current bitmap.
+ * @param buffer The buffer bitmap, only passed on to a custom energy function. The default energy calculation does not use it, so it may be empty then.
+ * @param lastScore The last score.
+ * @param customEnergyFunction An optional function to calculate the energy (if unspecified a default implementation is used).
+ * @return The best state acquired from hill climbing i.e. the one with the lowest energy.
+ */
+geometrize::State bestHillClimbState(
+        const geometrize::ShapeSlotCreator& shapeCreator,
+        geometrize::ShapeArena& arena,
+        std::uint32_t alpha,
+        std::uint32_t n,
+        std::uint32_t age,
+        const geometrize::Bitmap& target,
+        const geometrize::Bitmap& current,
+        geometrize::Bitmap& buffer,
+        double lastScore,
+        const EnergyFunction& customEnergyFunction = nullptr);
+
 }
 
 }
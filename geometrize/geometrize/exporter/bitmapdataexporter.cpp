@@ -20,14 +20,10 @@ std::string exportBitmapData(const geometrize::Bitmap& bitmapData)
 {
     std::ostringstream stream(std::ios::binary);
 
+    // The rows are written whole, since they are already in RGBA8888 order
+    const std::streamsize rowSize{static_cast<std::streamsize>(bitmapData.getWidth()) * 4};
     for(std::uint32_t y = 0U; y < bitmapData.getHeight(); y++) {
-        for(std::uint32_t x = 0U; x < bitmapData.getWidth(); x++) {
-            const geometrize::rgba pixel(bitmapData.getPixel(x, y));
-            writeToStream(stream, pixel.r);
-            writeToStream(stream, pixel.g);
-            writeToStream(stream, pixel.b);
-            writeToStream(stream, pixel.a);
-        }
+        stream.write(reinterpret_cast<const char*>(bitmapData.rowPtr(y)), rowSize);
     }
 
     return stream.str();
@@ -1,5 +1,6 @@
 #include "bitmapexporter.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <sstream>
 
@@ -103,11 +104,11 @@ std::string exportBMP(const geometrize::Bitmap& bitmapData)
 
     // Bitmap Image Data
     for(std::uint32_t y = 0U; y < bitmapData.getHeight(); y++) {
-        for(std::uint32_t x = 0U; x < bitmapData.getWidth(); x++) {
-            const geometrize::rgba pixel(bitmapData.getPixel(x, y));
-            writeToStream(stream, pixel.b);
-            writeToStream(stream, pixel.g);
-            writeToStream(stream, pixel.r);
+        const std::uint8_t* const row{bitmapData.rowPtr(y)};
+        for(std::size_t i = 0U; i < static_cast<std::size_t>(bitmapData.getWidth()) * 4U; i += 4U) {
+            writeToStream(stream, row[i + 2U]);
+            writeToStream(stream, row[i + 1U]);
+            writeToStream(stream, row[i]);
         }
         for (std::uint32_t pad = 0U; pad < padding; pad++) {
             const std::uint8_t zeroPad{0U};
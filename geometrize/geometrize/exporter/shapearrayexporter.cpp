@@ -1,13 +1,39 @@
 #include "shapearrayexporter.h"
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "shapeserializer.h"
+#include "../bitmap/rgba.h"
 #include "../shape/shape.h"
 #include "../shape/shapetypes.h"
 #include "../shaperesult.h"
+#include "../shaperesultstore.h"
+
+namespace
+{
+
+void writeShape(std::ostringstream& stream, const geometrize::ShapeTypes type, const std::vector<float>& shapeData, const geometrize::rgba color)
+{
+    stream << static_cast<std::underlying_type<geometrize::ShapeTypes>::type>(type) << "\n";
+
+    for(std::size_t d = 0; d < shapeData.size(); d++) {
+        stream << shapeData[d];
+        if(d != (shapeData.size() - 1U)) {
+            stream << ",";
+        }
+    }
+    stream << "\n";
+
+    stream << static_cast<std::uint32_t>(color.r) << ","
+           << static_cast<std::uint32_t>(color.g) << ","
+           << static_cast<std::uint32_t>(color.b) << ","
+           << static_cast<std::uint32_t>(color.a);
+}
+
+}
 
 namespace geometrize
 {
@@ -22,21 +48,22 @@ std::string exportShapeArray(const std::vector<geometrize::ShapeResult>& data)
     for(std::size_t i = 0; i < data.size(); i++) {
         const geometrize::ShapeResult& s(data[i]);
 
-        stream << static_cast<std::underlying_type<geometrize::ShapeTypes>::type>(s.shape->getType()) << "\n";
+        writeShape(stream, s.shape->getType(), getRawShapeData(*s.shape.get()), s.color);
 
-        const std::vector<float> shapeData{getRawShapeData(*s.shape.get())};
-        for(std::size_t d = 0; d < shapeData.size(); d++) {
-            stream << shapeData[d];
-            if(d != (shapeData.size() - 1U)) {
-                stream << ",";
-            }
+        if(i != (data.size() - 1U)) {
+            stream << "\n";
         }
-        stream << "\n";
+    }
+
+    return stream.str();
+}
 
-        stream << static_cast<std::uint32_t>(s.color.r) << ","
-               << static_cast<std::uint32_t>(s.color.g) << ","
-               << static_cast<std::uint32_t>(s.color.b) << ","
-               << static_cast<std::uint32_t>(s.color.a);
+std::string exportShapeArray(const geometrize::ShapeResultStore& data)
+{
+    std::ostringstream stream;
+
+    for(std::size_t i = 0; i < data.size(); i++) {
+        writeShape(stream, data.getType(i), getRawShapeData(data, i), data.getColor(i));
 
         if(i != (data.size() - 1U)) {
             stream << "\n";
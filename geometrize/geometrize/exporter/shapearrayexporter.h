@@ -5,6 +5,7 @@
 
 namespace geometrize
 {
+class ShapeResultStore;
 struct ShapeResult;
 }
 
@@ -25,6 +26,13 @@ namespace exporter
  */
 std::string exportShapeArray(const std::vector<geometrize::ShapeResult>& data);
 
+/**
+ * @brief exportShapeArray Exports shape data held in a compact shape result store to the array-style format.
+ * @param data The shape data to export.
+ * @return A string containing the exported data.
+ */
+std::string exportShapeArray(const geometrize::ShapeResultStore& data);
+
 }
 
 }
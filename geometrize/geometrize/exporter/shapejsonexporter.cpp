@@ -6,9 +6,29 @@
 #include <vector>
 
 #include "shapeserializer.h"
+#include "../bitmap/rgba.h"
 #include "../shape/shape.h"
 #include "../shape/shapetypes.h"
 #include "../shaperesult.h"
+#include "../shaperesultstore.h"
+
+namespace
+{
+
+void writeShape(std::ostringstream& stream, const geometrize::ShapeTypes type, const std::vector<float>& shapeData, const geometrize::rgba color, const double score)
+{
+    stream << "{" << "\"type\":" << static_cast<std::underlying_type<geometrize::ShapeTypes>::type>(type) << ", \"data\":[";
+    for(std::size_t d = 0; d < shapeData.size(); d++) {
+        stream << shapeData[d];
+        if(d <= shapeData.size() - 2) {
+            stream << ",";
+        }
+    }
+    stream << "],\"color\":[" << static_cast<std::uint32_t>(color.r) << "," << static_cast<std::uint32_t>(color.g) << "," << static_cast<std::uint32_t>(color.b) << "," << static_cast<std::uint32_t>(color.a) << "],";
+    stream << "\"score\":" << score << "}";
+}
+
+}
 
 namespace geometrize
 {
@@ -23,20 +43,25 @@ std::string exportShapeJson(const std::vector<geometrize::ShapeResult>& data)
 
     for(std::size_t i = 0; i < data.size(); i++) {
         const geometrize::ShapeResult& s(data[i]);
-        const geometrize::ShapeTypes type{s.shape->getType()};
-        const std::vector<float> shapeData{getRawShapeData(*s.shape.get())};
-        const geometrize::rgba color(s.color);
-        const double score{s.score};
-
-        stream << "{" << "\"type\":" << static_cast<std::underlying_type<geometrize::ShapeTypes>::type>(type) << ", \"data\":[";
-        for(std::size_t d = 0; d < shapeData.size(); d++) {
-            stream << shapeData[d];
-            if(d <= shapeData.size() - 2) {
-                stream << ",";
-            }
+
+        writeShape(stream, s.shape->getType(), getRawShapeData(*s.shape.get()), s.color, s.score);
+
+        if(i <= data.size() - 2) {
+            stream << ",\n";
         }
-        stream << "],\"color\":[" << static_cast<std::uint32_t>(color.r) << "," << static_cast<std::uint32_t>(color.g) << "," << static_cast<std::uint32_t>(color.b) << "," << static_cast<std::uint32_t>(color.a) << "],";
-        stream << "\"score\":" << score << "}";
+    }
+
+    stream << "\n]}";
+    return stream.str();
+}
+
+std::string exportShapeJson(const geometrize::ShapeResultStore& data)
+{
+    std::ostringstream stream;
+    stream << "{\"shapes\":\n[";
+
+    for(std::size_t i = 0; i < data.size(); i++) {
+        writeShape(stream, data.getType(i), getRawShapeData(data, i), data.getColor(i), data.getScore(i));
 
         if(i <= data.size() - 2) {
             stream << ",\n";
@@ -5,6 +5,7 @@
 
 namespace geometrize
 {
+class ShapeResultStore;
 struct ShapeResult;
 }
 
@@ -21,6 +22,13 @@ namespace exporter
  */
 std::string exportShapeJson(const std::vector<geometrize::ShapeResult>& data);
 
+/**
+ * @brief exportShapeJson Exports shape data held in a compact shape result store to JSON.
+ * @param data The shape data to export.
+ * @return A string containing the exported JSON.
+ */
+std::string exportShapeJson(const geometrize::ShapeResultStore& data);
+
 }
 
 }
@@ -1,33 +1,57 @@
-#pragma once
-
-#include <vector>
-
-namespace geometrize
-{
-class Circle;
-class Ellipse;
-class Line;
-class Polyline;
-class QuadraticBezier;
-class Rectangle;
-class RotatedEllipse;
-class RotatedRectangle;
-class Shape;
-class Triangle;
-}
-
-namespace geometrize
-{
-
-std::vector<float> getRawShapeData(const geometrize::Shape& s);
-std::vector<float> getRawShapeData(const geometrize::Circle& s);
-std::vector<float> getRawShapeData(const geometrize::Ellipse& s);
-std::vector<float> getRawShapeData(const geometrize::Line& s);
-std::vector<float> getRawShapeData(const geometrize::Polyline& s);
-std::vector<float> getRawShapeData(const geometrize::QuadraticBezier& s);
-std::vector<float> getRawShapeData(const geometrize::Rectangle& s);
-std::vector<float> getRawShapeData(const geometrize::RotatedEllipse& s);
-std::vector<float> getRawShapeData(const geometrize::RotatedRectangle& s);
-std::vector<float> getRawShapeData(const geometrize::Triangle& s);
-
-}
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace geometrize
+{
+class Circle;
+class Ellipse;
+class Line;
+class Polyline;
+class QuadraticBezier;
+class Rectangle;
+class RotatedEllipse;
+class RotatedRectangle;
+class Shape;
+class Triangle;
+class ShapeResultStore;
+struct CircleValue;
+struct EllipseValue;
+struct LineValue;
+struct PolylineValue;
+struct PolylineView;
+struct QuadraticBezierValue;
+struct RectangleValue;
+struct RotatedEllipseValue;
+struct RotatedRectangleValue;
+struct TriangleValue;
+}
+
+namespace geometrize
+{
+
+std::vector<float> getRawShapeData(const geometrize::Shape& s);
+std::vector<float> getRawShapeData(const geometrize::Circle& s);
+std::vector<float> getRawShapeData(const geometrize::Ellipse& s);
+std::vector<float> getRawShapeData(const geometrize::Line& s);
+std::vector<float> getRawShapeData(const geometrize::Polyline& s);
+std::vector<float> getRawShapeData(const geometrize::QuadraticBezier& s);
+std::vector<float> getRawShapeData(const geometrize::Rectangle& s);
+std::vector<float> getRawShapeData(const geometrize::RotatedEllipse& s);
+std::vector<float> getRawShapeData(const geometrize::RotatedRectangle& s);
+std::vector<float> getRawShapeData(const geometrize::Triangle& s);
+
+std::vector<float> getRawShapeData(const geometrize::ShapeResultStore& store, std::size_t index);
+std::vector<float> getRawShapeData(const geometrize::CircleValue& s);
+std::vector<float> getRawShapeData(const geometrize::EllipseValue& s);
+std::vector<float> getRawShapeData(const geometrize::LineValue& s);
+std::vector<float> getRawShapeData(const geometrize::PolylineValue& s);
+std::vector<float> getRawShapeData(const geometrize::PolylineView& s);
+std::vector<float> getRawShapeData(const geometrize::QuadraticBezierValue& s);
+std::vector<float> getRawShapeData(const geometrize::RectangleValue& s);
+std::vector<float> getRawShapeData(const geometrize::RotatedEllipseValue& s);
+std::vector<float> getRawShapeData(const geometrize::RotatedRectangleValue& s);
+std::vector<float> getRawShapeData(const geometrize::TriangleValue& s);
+
+}
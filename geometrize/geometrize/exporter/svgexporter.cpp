@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <regex>
 #include <sstream>
@@ -21,34 +22,36 @@
 #include "../shape/rotatedellipse.h"
 #include "../shape/rotatedrectangle.h"
 #include "../shape/triangle.h"
+#include "../shape/shapevalue.h"
 #include "../shaperesult.h"
+#include "../shaperesultstore.h"
 #include "../commonutil.h"
 
 namespace
 {
 
-std::string getSvgShapeData(const geometrize::Circle& s)
+template<typename T> std::string svgShapeDataCircle(const T& s)
 {
     std::stringstream strm;
     strm << "<circle cx=\"" << s.m_x << "\" cy=\"" << s.m_y << "\" r=\"" << s.m_r << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::Ellipse& s)
+template<typename T> std::string svgShapeDataEllipse(const T& s)
 {
     std::stringstream strm;
     strm << "<ellipse cx=\"" << s.m_x << "\" cy=\"" << s.m_y << "\" rx=\"" << s.m_rx << "\" ry=\"" << s.m_ry << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::Line& s)
+template<typename T> std::string svgShapeDataLine(const T& s)
 {
     std::stringstream strm;
     strm << "<line x1=\"" << s.m_x1 << "\" y1=\"" << s.m_y1 << "\" x2=\"" << s.m_x2 << "\" y2=\"" << s.m_y2 << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::Polyline& s)
+template<typename T> std::string svgShapeDataPolyline(const T& s)
 {
     std::stringstream strm;
     strm << "<polyline points=\"";
@@ -66,21 +69,43 @@ std::string getSvgShapeData(const geometrize::Polyline& s)
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::QuadraticBezier& s)
+template<typename T> std::string svgShapeDataQuadraticBezier(const T& s, const geometrize::exporter::QuadraticBezierSVGExportMode mode)
 {
     std::stringstream strm;
-    strm << "<path d=\"M" << s.m_x1 << " " << s.m_y1 << " Q " << s.m_cx << " " << s.m_cy << " " << s.m_x2 << " " << s.m_y2 << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
+
+    switch(mode) {
+    case geometrize::exporter::QuadraticBezierSVGExportMode::PATH:
+        {
+            strm << "<path d=\"M" << s.m_x1 << " " << s.m_y1 << " Q " << s.m_cx << " " << s.m_cy << " " << s.m_x2 << " " << s.m_y2 << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
+        }
+        break;
+    case geometrize::exporter::QuadraticBezierSVGExportMode::POLYLINE:
+        {
+            const std::vector<std::pair<float, float>> points{geometrize::getPointsOnQuadraticBezier(s, geometrize::QUADRATIC_BEZIER_FLATNESS_TOLERANCE)};
+
+            strm << "<polyline points=\"";
+            for(std::size_t i = 0; i < points.size(); i++) {
+                strm << points[i].first << "," << points[i].second;
+                if(i != points.size() - 1) {
+                    strm << " ";
+                }
+            }
+            strm << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
+        }
+        break;
+    }
+
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::Rectangle& s)
+template<typename T> std::string svgShapeDataRectangle(const T& s)
 {
     std::stringstream strm;
     strm << "<rect x=\"" << (std::fmin)(s.m_x1, s.m_x2) << "\" y=\"" << (std::fmin)(s.m_y1, s.m_y2) << "\" width=\"" << (std::fmax)(s.m_x1, s.m_x2) - (std::fmin)(s.m_x1, s.m_x2) << "\" height=\"" << (std::fmax)(s.m_y1, s.m_y2) - (std::fmin)(s.m_y1, s.m_y2) << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " />";
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::RotatedEllipse& s, const geometrize::exporter::RotatedEllipseSVGExportMode mode)
+template<typename T> std::string svgShapeDataRotatedEllipse(const T& s, const geometrize::exporter::RotatedEllipseSVGExportMode mode)
 {
     std::stringstream strm;
 
@@ -112,7 +137,7 @@ std::string getSvgShapeData(const geometrize::RotatedEllipse& s, const geometriz
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::RotatedRectangle& s)
+template<typename T> std::string svgShapeDataRotatedRectangle(const T& s)
 {
     const std::vector<std::pair<float, float>> points{geometrize::getCornerPoints(s)};
     std::stringstream strm;
@@ -127,7 +152,7 @@ std::string getSvgShapeData(const geometrize::RotatedRectangle& s)
     return strm.str();
 }
 
-std::string getSvgShapeData(const geometrize::Triangle& s)
+template<typename T> std::string svgShapeDataTriangle(const T& s)
 {
     std::stringstream strm;
     strm << "<polygon points=\"" << s.m_x1 << "," << s.m_y1 << " " << s.m_x2 << "," << s.m_y2 << " " << s.m_x3 << "," << s.m_y3 << "\" " << geometrize::exporter::SVG_STYLE_HOOK << " " << "/>";
@@ -138,23 +163,50 @@ std::string getSvgShapeData(const geometrize::Shape& s, const geometrize::export
 {
     switch(s.getType()) {
     case geometrize::ShapeTypes::RECTANGLE:
-        return getSvgShapeData(static_cast<const geometrize::Rectangle&>(s));
+        return svgShapeDataRectangle(static_cast<const geometrize::Rectangle&>(s));
     case geometrize::ShapeTypes::ROTATED_RECTANGLE:
-        return getSvgShapeData(static_cast<const geometrize::RotatedRectangle&>(s));
+        return svgShapeDataRotatedRectangle(static_cast<const geometrize::RotatedRectangle&>(s));
     case geometrize::ShapeTypes::TRIANGLE:
-        return getSvgShapeData(static_cast<const geometrize::Triangle&>(s));
+        return svgShapeDataTriangle(static_cast<const geometrize::Triangle&>(s));
     case geometrize::ShapeTypes::ELLIPSE:
-        return getSvgShapeData(static_cast<const geometrize::Ellipse&>(s));
+        return svgShapeDataEllipse(static_cast<const geometrize::Ellipse&>(s));
     case geometrize::ShapeTypes::ROTATED_ELLIPSE:
-        return getSvgShapeData(static_cast<const geometrize::RotatedEllipse&>(s), options.rotatedEllipseExportMode);
+        return svgShapeDataRotatedEllipse(static_cast<const geometrize::RotatedEllipse&>(s), options.rotatedEllipseExportMode);
     case geometrize::ShapeTypes::CIRCLE:
-        return getSvgShapeData(static_cast<const geometrize::Circle&>(s));
+        return svgShapeDataCircle(static_cast<const geometrize::Circle&>(s));
     case geometrize::ShapeTypes::LINE:
-        return getSvgShapeData(static_cast<const geometrize::Line&>(s));
+        return svgShapeDataLine(static_cast<const geometrize::Line&>(s));
     case geometrize::ShapeTypes::QUADRATIC_BEZIER:
-        return getSvgShapeData(static_cast<const geometrize::QuadraticBezier&>(s));
+        return svgShapeDataQuadraticBezier(static_cast<const geometrize::QuadraticBezier&>(s), options.quadraticBezierExportMode);
     case geometrize::ShapeTypes::POLYLINE:
-        return getSvgShapeData(static_cast<const geometrize::Polyline&>(s));
+        return svgShapeDataPolyline(static_cast<const geometrize::Polyline&>(s));
+    default:
+        assert(0 && "Bad shape type");
+        return "";
+    }
+}
+
+std::string getSvgShapeData(const geometrize::ShapeResultStore& store, const std::size_t index, const geometrize::exporter::SVGExportOptions& options)
+{
+    switch(store.getType(index)) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        return svgShapeDataRectangle(store.getRectangle(index));
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        return svgShapeDataRotatedRectangle(store.getRotatedRectangle(index));
+    case geometrize::ShapeTypes::TRIANGLE:
+        return svgShapeDataTriangle(store.getTriangle(index));
+    case geometrize::ShapeTypes::ELLIPSE:
+        return svgShapeDataEllipse(store.getEllipse(index));
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        return svgShapeDataRotatedEllipse(store.getRotatedEllipse(index), options.rotatedEllipseExportMode);
+    case geometrize::ShapeTypes::CIRCLE:
+        return svgShapeDataCircle(store.getCircle(index));
+    case geometrize::ShapeTypes::LINE:
+        return svgShapeDataLine(store.getLine(index));
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        return svgShapeDataQuadraticBezier(store.getQuadraticBezier(index), options.quadraticBezierExportMode);
+    case geometrize::ShapeTypes::POLYLINE:
+        return svgShapeDataPolyline(store.getPolyline(index));
     default:
         assert(0 && "Bad shape type");
         return "";
@@ -199,13 +251,10 @@ std::string getSVGStrokeOpacityAttrib(const geometrize::rgba color)
     return stream.str();
 }
 
-std::string getSingleShapeSVGData(const geometrize::rgba& color, const geometrize::Shape& shape, const geometrize::exporter::SVGExportOptions& options)
+std::string styleShapeSVGData(std::string shapeData, const geometrize::ShapeTypes shapeType, const geometrize::rgba& color, const geometrize::exporter::SVGExportOptions& options)
 {
     std::stringstream stream;
 
-    std::string shapeData{getSvgShapeData(shape, options)};
-    const geometrize::ShapeTypes shapeType{shape.getType()};
-
     std::string styles{""};
 
     styles.append("id=\"" + std::to_string(options.itemId) + "\" ");
@@ -229,6 +278,16 @@ std::string getSingleShapeSVGData(const geometrize::rgba& color, const geometriz
     return stream.str();
 }
 
+std::string getSingleShapeSVGData(const geometrize::rgba& color, const geometrize::Shape& shape, const geometrize::exporter::SVGExportOptions& options)
+{
+    return styleShapeSVGData(getSvgShapeData(shape, options), shape.getType(), color, options);
+}
+
+std::string getSingleShapeSVGData(const geometrize::ShapeResultStore& store, const std::size_t index, const geometrize::exporter::SVGExportOptions& options)
+{
+    return styleShapeSVGData(getSvgShapeData(store, index, options), store.getType(index), store.getColor(index), options);
+}
+
 }
 
 namespace geometrize
@@ -280,6 +339,27 @@ std::string exportSVG(const std::vector<geometrize::ShapeResult>& data, const st
     return stream.str();
 }
 
+
+std::string exportSVG(const geometrize::ShapeResultStore& data, const std::uint32_t width, const std::uint32_t height, SVGExportOptions options)
+{
+    std::stringstream stream;
+
+    stream << "<?xml version=\"1.0\" standalone=\"no\"?>" << "\n";
+    stream << "<svg xmlns=\"https://www.w3.org/2000/svg\" version=\"1.2\" baseProfile=\"tiny\" " <<
+              "width=\"" << width << "\" " << "height=\"" << height << "\" " <<
+              "viewBox=\"" << 0 << " " << 0 << " " << width << " " << height << "\">" << "\n";
+
+    for(std::size_t i = 0; i < data.size(); i++) {
+        options.itemId = i;
+
+        stream << ::getSingleShapeSVGData(data, i, options);
+    }
+
+    stream << "</svg>";
+
+    return stream.str();
+}
+
 }
 
 }
@@ -9,6 +9,7 @@
 namespace geometrize
 {
 class Shape;
+class ShapeResultStore;
 struct ShapeResult;
 }
 
@@ -29,12 +30,19 @@ enum class RotatedEllipseSVGExportMode
     POLYGON = 1 // Export as a <polygon>, OpenFL's SVG library can handle this, but it looks quite ugly
 };
 
+enum class QuadraticBezierSVGExportMode
+{
+    PATH = 0, // Export as a <path> with a quadratic curve command, which SVG renderers draw as a true curve, so it can differ slightly from the rasterized curve
+    POLYLINE = 1 // Export as a <polyline>, flattened with the same tolerance the rasterizer uses, so it matches the rasterized curve
+};
+
 /**
  * @brief The SVGExportOptions struct represents the options that can be set for the SVG export.
  */
 struct SVGExportOptions
 {
     RotatedEllipseSVGExportMode rotatedEllipseExportMode{ RotatedEllipseSVGExportMode::ELLIPSE_ITEM }; // Technique to use when exporting rotated ellipses
+    QuadraticBezierSVGExportMode quadraticBezierExportMode{ QuadraticBezierSVGExportMode::POLYLINE }; // Technique to use when exporting quadratic bezier curves, the default matches the raster output
     std::size_t itemId{ 0 }; // Id to tag the exported SVG shapes with
 };
 
@@ -68,6 +76,16 @@ std::string exportSingleShapeSVG(const geometrize::rgba& color, const geometrize
  */
 std::string exportSVG(const std::vector<geometrize::ShapeResult>& data, const std::uint32_t width, const std::uint32_t height, SVGExportOptions options = SVGExportOptions{});
 
+/**
+ * @brief exportSVG Exports shape data held in a compact shape result store as a complete SVG image.
+ * @param data The shape data to export.
+ * @param width The width of the SVG image.
+ * @param height The height of the SVG image.
+ * @param options additional options used by the exporter.
+ * @return A string representing the SVG image.
+ */
+std::string exportSVG(const geometrize::ShapeResultStore& data, const std::uint32_t width, const std::uint32_t height, SVGExportOptions options = SVGExportOptions{});
+
 }
 
 }
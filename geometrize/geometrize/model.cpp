@@ -9,15 +9,22 @@
 #include <future>
 #include <iostream>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "bitmap/bitmap.h"
+#include "bitmap/bitmappyramid.h"
+#include "bitmap/planarbitmap.h"
 #include "commonutil.h"
 #include "core.h"
+#include "rasterizer/boundingbox.h"
 #include "rasterizer/rasterizer.h"
+#include "rasterizer/scanlineundobuffer.h"
 #include "shape/shape.h"
+#include "shape/shapearena.h"
 #include "shaperesult.h"
 #include "shape/shapetypes.h"
+#include "targetcache.h"
 
 namespace
 {
@@ -35,6 +42,11 @@ bool defaultAddShapePrecondition(
     return newScore < lastScore; // Adds the shape if the score improved (that is: the difference decreased)
 }
 
+geometrize::BoundingBox getBitmapBounds(const geometrize::Bitmap& bitmap)
+{
+    return geometrize::BoundingBox{0, 0, static_cast<std::int32_t>(bitmap.getWidth()) - 1, static_cast<std::int32_t>(bitmap.getHeight()) - 1};
+}
+
 }
 
 namespace geometrize
@@ -44,22 +56,49 @@ class Model::ModelImpl
 {
 public:
     ModelImpl(const geometrize::Bitmap& target) :
+        m_privateTarget{std::make_shared<geometrize::Bitmap>(target)},
+        m_target{m_privateTarget},
+        m_current{target.getWidth(), target.getHeight(), geometrize::commonutil::getAverageImageColor(*m_target)},
+        m_lastScore{geometrize::core::differenceFull(*m_target, m_current)},
+        m_dirtyRegion{getBitmapBounds(m_current)},
+        m_baseRandomSeed{0U},
+        m_randomSeedOffset{0U}
+    {}
+
+    ModelImpl(const geometrize::Bitmap& target, geometrize::Bitmap initial) :
+        m_privateTarget{std::make_shared<geometrize::Bitmap>(target)},
+        m_target{m_privateTarget},
+        m_current{std::move(initial)},
+        m_lastScore{geometrize::core::differenceFull(*m_target, m_current)},
+        m_dirtyRegion{getBitmapBounds(m_current)},
+        m_baseRandomSeed{0U},
+        m_randomSeedOffset{0U}
+    {
+        assert(m_target->getWidth() == m_current.getWidth());
+        assert(m_target->getHeight() == m_current.getHeight());
+    }
+
+    ModelImpl(const std::shared_ptr<const geometrize::Bitmap>& target) :
         m_target{target},
-        m_current{target.getWidth(), target.getHeight(), geometrize::commonutil::getAverageImageColor(m_target)},
-        m_lastScore{geometrize::core::differenceFull(m_target, m_current)},
+        m_targetCache{geometrize::TargetCache::get(target)},
+        m_current{target->getWidth(), target->getHeight(), m_targetCache->getAverageColor()},
+        m_lastScore{geometrize::core::differenceFull(*m_target, m_current)},
+        m_dirtyRegion{getBitmapBounds(m_current)},
         m_baseRandomSeed{0U},
         m_randomSeedOffset{0U}
     {}
 
-    ModelImpl(const geometrize::Bitmap& target, const geometrize::Bitmap& initial) :
+    ModelImpl(const std::shared_ptr<const geometrize::Bitmap>& target, geometrize::Bitmap initial) :
         m_target{target},
-        m_current{initial},
-        m_lastScore{geometrize::core::differenceFull(m_target, m_current)},
+        m_targetCache{geometrize::TargetCache::get(target)},
+        m_current{std::move(initial)},
+        m_lastScore{geometrize::core::differenceFull(*m_target, m_current)},
+        m_dirtyRegion{getBitmapBounds(m_current)},
         m_baseRandomSeed{0U},
         m_randomSeedOffset{0U}
     {
-        assert(m_target.getWidth() == m_current.getWidth());
-        assert(m_target.getHeight() == m_current.getHeight());
+        assert(m_target->getWidth() == m_current.getWidth());
+        assert(m_target->getHeight() == m_current.getHeight());
     }
 
     ~ModelImpl() = default;
@@ -69,26 +108,34 @@ public:
     void reset(const geometrize::rgba backgroundColor)
     {
         m_current.fill(backgroundColor);
-        m_lastScore = geometrize::core::differenceFull(m_target, m_current);
+        currentChanged();
+    }
+
+    void currentChanged()
+    {
+        m_planarCurrent = nullptr;
+        m_currentPyramid = nullptr;
+        for(geometrize::Bitmap& buffer : m_buffers) {
+            buffer = m_current;
+        }
+        m_lastScore = geometrize::core::differenceFull(*m_target, m_current);
+        m_dirtyRegion = getBitmapBounds(m_current);
     }
 
     std::int32_t getWidth() const
     {
-        return m_target.getWidth();
+        return m_target->getWidth();
     }
 
     std::int32_t getHeight() const
     {
-        return m_target.getHeight();
+        return m_target->getHeight();
     }
 
     std::vector<geometrize::State> getHillClimbState(
-            const std::function<std::shared_ptr<geometrize::Shape>(void)> shapeCreator,
-            const std::uint8_t alpha,
-            const std::uint32_t shapeCount,
-            const std::uint32_t maxShapeMutations,
-            std::uint32_t maxThreads,
-            const geometrize::core::EnergyFunction energyFunction)
+            const std::function<geometrize::State(geometrize::Bitmap&, const geometrize::core::EnergyFunction&, double)>& search,
+            const geometrize::core::EnergyFunction& energyFunction,
+            std::uint32_t maxThreads)
     {
         // Ensure that the maximum number of threads is a sane value
         if(maxThreads == 0) {
@@ -99,16 +146,41 @@ public:
             }
         }
 
+        // Only custom energy functions draw into a buffer, the default energy calculation scores shapes straight from the current bitmap
+        // The buffers start as copies of the current bitmap and are kept in step with it, so it is not copied for each thread on every step
+        if(energyFunction) {
+            while(m_buffers.size() < maxThreads) {
+                m_buffers.emplace_back(m_current);
+            }
+        }
+
+        // Custom energy functions draw each candidate shape on a buffer, so the pixels under the shape are put back after it is scored
+        const geometrize::core::EnergyFunction restoringEnergyFunction{!energyFunction ? nullptr : geometrize::core::EnergyFunction([&energyFunction](
+                const std::vector<geometrize::Scanline>& lines,
+                const std::uint32_t alpha,
+                const geometrize::Bitmap& target,
+                const geometrize::Bitmap& current,
+                geometrize::Bitmap& buffer,
+                const double score) {
+            const double energy{energyFunction(lines, alpha, target, current, buffer, score)};
+            geometrize::copyLines(buffer, current, lines);
+            return energy;
+        })};
+
         std::vector<std::future<geometrize::State>> futures{maxThreads};
         for(std::uint32_t i = 0; i < futures.size(); i++) {
-            std::future<geometrize::State> handle{std::async(std::launch::async, [&](const std::uint32_t seed, const double lastScore) {
+            geometrize::Bitmap* const buffer{energyFunction ? &m_buffers[i] : nullptr};
+            std::future<geometrize::State> handle{std::async(std::launch::async, [&search, &restoringEnergyFunction, buffer](const std::uint32_t seed, const double lastScore) {
                 // Ensure that the results of the random generation are the same between tasks with identical settings
                 // The RNG is thread-local and std::async may use a thread pool (which is why this is necessary)
                 // Note this implementation requires maxThreads to be the same between tasks for each task to produce the same results.
                 geometrize::commonutil::seedRandomGenerator(seed);
 
-                geometrize::Bitmap buffer{m_current};
-                return core::bestHillClimbState(shapeCreator, alpha, shapeCount, maxShapeMutations, m_target, m_current, buffer, lastScore, energyFunction);
+                if(!buffer) {
+                    geometrize::Bitmap unused{0U, 0U, std::vector<std::uint8_t>{}};
+                    return search(unused, nullptr, lastScore);
+                }
+                return search(*buffer, restoringEnergyFunction, lastScore);
             }, m_baseRandomSeed + m_randomSeedOffset++, m_lastScore)};
             futures[i] = std::move(handle);
         }
@@ -139,7 +211,65 @@ public:
             const geometrize::core::EnergyFunction& energyFunction,
             const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
     {
-        std::vector<geometrize::State> states{getHillClimbState(shapeCreator, alpha, shapeCount, maxShapeMutations, maxThreads, energyFunction)};
+        std::vector<geometrize::State> states{getHillClimbState([&](geometrize::Bitmap& buffer, const geometrize::core::EnergyFunction& energy, const double lastScore) {
+            return core::bestHillClimbState(shapeCreator, alpha, shapeCount, maxShapeMutations, *m_target, m_current, buffer, lastScore, energy);
+        }, energyFunction, maxThreads)};
+        return addBestState(states, alpha, addShapePrecondition);
+    }
+
+    std::vector<geometrize::ShapeResult> step(
+            const geometrize::ShapeTypes types,
+            const std::int32_t xMin,
+            const std::int32_t yMin,
+            const std::int32_t xMax,
+            const std::int32_t yMax,
+            const std::uint8_t alpha,
+            const std::uint32_t shapeCount,
+            const std::uint32_t maxShapeMutations,
+            const std::uint32_t maxThreads,
+            const geometrize::core::EnergyFunction& energyFunction,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+    {
+        // The default energy function is calculated on planar copies of the target and current bitmaps, unless they are mapped from files (and may not fit in memory)
+        // or the target is borrowed from a view, which the model promises not to copy
+        const bool usePlanar{!energyFunction && !m_target->isMapped() && !m_target->isBorrowed() && !m_current.isMapped()};
+        if(usePlanar) {
+            updatePlanarImages();
+        }
+        const geometrize::PlanarBitmap* const planarTarget{usePlanar ? m_planarTarget.get() : nullptr};
+        const geometrize::PlanarBitmap* const planarCurrent{usePlanar ? m_planarCurrent.get() : nullptr};
+
+        std::vector<geometrize::State> states{getHillClimbState([&](geometrize::Bitmap& buffer, const geometrize::core::EnergyFunction& energy, const double lastScore) {
+            return core::bestHillClimbState(types, xMin, yMin, xMax, yMax, alpha, shapeCount, maxShapeMutations, *m_target, m_current, buffer, lastScore, energy, planarTarget, planarCurrent);
+        }, energyFunction, maxThreads)};
+        return addBestState(states, alpha, addShapePrecondition);
+    }
+
+    std::vector<geometrize::ShapeResult> step(
+            const geometrize::ShapeSlotCreator& shapeCreator,
+            const std::int32_t xMin,
+            const std::int32_t yMin,
+            const std::int32_t xMax,
+            const std::int32_t yMax,
+            const std::uint8_t alpha,
+            const std::uint32_t shapeCount,
+            const std::uint32_t maxShapeMutations,
+            const std::uint32_t maxThreads,
+            const geometrize::core::EnergyFunction& energyFunction,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+    {
+        std::vector<geometrize::State> states{getHillClimbState([&](geometrize::Bitmap& buffer, const geometrize::core::EnergyFunction& energy, const double lastScore) {
+            geometrize::ShapeArena arena{xMin, yMin, xMax, yMax};
+            return core::bestHillClimbState(shapeCreator, arena, alpha, shapeCount, maxShapeMutations, *m_target, m_current, buffer, lastScore, energy);
+        }, energyFunction, maxThreads)};
+        return addBestState(states, alpha, addShapePrecondition);
+    }
+
+    std::vector<geometrize::ShapeResult> addBestState(
+            std::vector<geometrize::State>& states,
+            const std::uint8_t alpha,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+    {
         if(states.empty()) {
             assert(0 && "Failed to get a hill climb state");
             return {};
@@ -149,22 +279,47 @@ public:
             return a.m_score < b.m_score;
         });
 
-        // Draw the shape onto the image
-        const std::shared_ptr<geometrize::Shape> shape = it->m_shape;
-        const std::vector<geometrize::Scanline> lines{shape->rasterize(*shape)};
-        const geometrize::rgba color(geometrize::core::computeColor(m_target, m_current, lines, alpha));
-        const geometrize::Bitmap before{m_current};
+        // Draw the shape onto the image, reusing the scanlines and color cached during hill climbing where possible
+        const std::vector<geometrize::Scanline>& lines{it->rasterize()};
+        const geometrize::rgba color(it->m_hasColor ? it->m_color : geometrize::core::computeColor(*m_target, m_current, lines, alpha));
+        return addShape(it->m_shape, lines, color, addShapePrecondition);
+    }
+
+    std::vector<geometrize::ShapeResult> addShape(
+            const std::shared_ptr<geometrize::Shape> shape,
+            const geometrize::rgba color,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+    {
+        return addShape(shape, shape->rasterize(*shape), color, addShapePrecondition);
+    }
+
+    std::vector<geometrize::ShapeResult> addShape(
+            const std::shared_ptr<geometrize::Shape>& shape,
+            const std::vector<geometrize::Scanline>& lines,
+            const geometrize::rgba color,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+    {
+        m_undoBuffer.save(m_current, lines);
         geometrize::drawLines(m_current, color, lines);
 
         // Check for an improvement - if not, roll back and return no result
-        const double newScore = geometrize::core::differencePartial(m_target, before, m_current, m_lastScore, lines);
-        const auto& addShapeCondition = addShapePrecondition ? addShapePrecondition : defaultAddShapePrecondition;
-        if(!addShapeCondition(m_lastScore, newScore, *shape, lines, color, before, m_current, m_target)) {
-            m_current = before;
+        const double newScore = geometrize::core::differencePartial(*m_target, m_undoBuffer, m_current, m_lastScore);
+        bool accepted{false};
+        if(addShapePrecondition) {
+            // Custom preconditions are given the whole bitmap from before the shape was drawn, so only then is it rebuilt
+            geometrize::Bitmap before{m_current};
+            m_undoBuffer.restore(before);
+            accepted = addShapePrecondition(m_lastScore, newScore, *shape, lines, color, before, m_current, *m_target);
+        } else {
+            accepted = defaultAddShapePrecondition(m_lastScore, newScore, *shape, lines, color, m_current, m_current, *m_target); // Only compares the scores
+        }
+        if(!accepted) {
+            m_undoBuffer.restore(m_current);
             return {};
         }
 
         // Improvement - set new baseline and return the new shape
+        linesChanged(lines);
         m_lastScore = newScore;
         const geometrize::ShapeResult result{m_lastScore, color, shape};
         return { result };
@@ -175,18 +330,46 @@ public:
             const geometrize::rgba color)
     {
         const std::vector<geometrize::Scanline> lines{shape->rasterize(*shape)};
-        const geometrize::Bitmap before{m_current};
+        m_undoBuffer.save(m_current, lines);
         geometrize::drawLines(m_current, color, lines);
+        linesChanged(lines);
 
-        m_lastScore = geometrize::core::differencePartial(m_target, before, m_current, m_lastScore, lines);
+        m_lastScore = geometrize::core::differencePartial(*m_target, m_undoBuffer, m_current, m_lastScore);
 
         const geometrize::ShapeResult result{m_lastScore, color, shape};
         return result;
     }
 
+    void copyLines(const geometrize::Bitmap& source, const std::vector<geometrize::Scanline>& lines)
+    {
+        assert(source.getWidth() == m_current.getWidth() && source.getHeight() == m_current.getHeight());
+
+        m_undoBuffer.save(m_current, lines);
+        geometrize::copyLines(m_current, source, lines);
+        linesChanged(lines);
+
+        m_lastScore = geometrize::core::differencePartial(*m_target, m_undoBuffer, m_current, m_lastScore);
+    }
+
+    const geometrize::BitmapPyramid& getCurrentPyramid(const std::uint32_t levelCount)
+    {
+        if(!m_currentPyramid || m_currentPyramidLevelCount < levelCount) {
+            m_currentPyramid = std::unique_ptr<geometrize::BitmapPyramid>(new geometrize::BitmapPyramid(m_current, levelCount));
+            m_currentPyramidLevelCount = levelCount;
+        }
+        return *m_currentPyramid;
+    }
+
     geometrize::Bitmap& getTarget()
     {
-        return m_target;
+        // Take a private copy of a shared target before handing out a reference that could change it
+        if(!m_privateTarget) {
+            m_privateTarget = std::make_shared<geometrize::Bitmap>(*m_target);
+            m_target = m_privateTarget;
+        }
+        m_targetCache = nullptr; // The target may be changed through the reference, so the data derived from it is looked up again
+        m_planarTarget = nullptr;
+        return *m_privateTarget;
     }
 
     geometrize::Bitmap& getCurrent()
@@ -195,6 +378,11 @@ public:
     }
 
     const geometrize::Bitmap& getTarget() const
+    {
+        return *m_target;
+    }
+
+    std::shared_ptr<const geometrize::Bitmap> getSharedTarget() const
     {
         return m_target;
     }
@@ -204,15 +392,90 @@ public:
         return m_current;
     }
 
+    geometrize::BoundingBox getDirtyRegion() const
+    {
+        return m_dirtyRegion;
+    }
+
+    void clearDirtyRegion()
+    {
+        m_dirtyRegion = geometrize::BoundingBox{0, 0, -1, -1};
+    }
+
     void setSeed(const std::uint32_t seed)
     {
         m_baseRandomSeed = seed;
     }
 
 private:
-    geometrize::Bitmap m_target; ///< The target bitmap, the bitmap we aim to approximate.
+    geometrize::TargetCache& getTargetCache()
+    {
+        if(!m_targetCache) {
+            m_targetCache = geometrize::TargetCache::get(m_target);
+        }
+        return *m_targetCache;
+    }
+
+    void updatePlanarImages()
+    {
+        // Drop the alpha planes if everything is opaque, drawing shapes on an opaque bitmap leaves it opaque
+        // Only the copies that were invalidated are made again, and the planar target is shared by every model using the same target
+        if(!m_planarCurrent) {
+            m_currentOpaque = geometrize::PlanarBitmap::isOpaque(m_current);
+        }
+        const bool keepAlpha{!m_currentOpaque || !getTargetCache().isOpaque()};
+        if(!m_planarTarget || m_planarTarget->hasAlpha() != keepAlpha) {
+            m_planarTarget = getTargetCache().getPlanar(keepAlpha);
+        }
+        if(!m_planarCurrent || m_planarCurrent->hasAlpha() != keepAlpha) {
+            m_planarCurrent = std::unique_ptr<geometrize::PlanarBitmap>(new geometrize::PlanarBitmap(m_current, keepAlpha));
+        }
+    }
+
+    void linesChanged(const std::vector<geometrize::Scanline>& lines)
+    {
+        // Bring the copies of the current bitmap back in step, copying or re-filtering only the pixels under the changed scanlines
+        if(m_planarCurrent) {
+            for(const geometrize::Scanline& line : lines) {
+                m_planarCurrent->copySpan(m_current, line.y, line.x1, line.x2);
+            }
+        }
+        for(geometrize::Bitmap& buffer : m_buffers) {
+            geometrize::copyLines(buffer, m_current, lines);
+        }
+        if(m_currentPyramid) {
+            m_currentPyramid->update(m_current, lines);
+        }
+        addDirtyLines(lines);
+    }
+
+    void addDirtyLines(const std::vector<geometrize::Scanline>& lines)
+    {
+        for(const geometrize::Scanline& line : lines) {
+            if(m_dirtyRegion.xMax < m_dirtyRegion.xMin) {
+                m_dirtyRegion = geometrize::BoundingBox{line.x1, line.y, line.x2, line.y};
+                continue;
+            }
+            m_dirtyRegion.xMin = (std::min)(m_dirtyRegion.xMin, line.x1);
+            m_dirtyRegion.yMin = (std::min)(m_dirtyRegion.yMin, line.y);
+            m_dirtyRegion.xMax = (std::max)(m_dirtyRegion.xMax, line.x2);
+            m_dirtyRegion.yMax = (std::max)(m_dirtyRegion.yMax, line.y);
+        }
+    }
+
+    std::shared_ptr<geometrize::Bitmap> m_privateTarget; ///< The target bitmap if the model has its own copy of it, else null.
+    std::shared_ptr<const geometrize::Bitmap> m_target; ///< The target bitmap, the bitmap we aim to approximate. May be shared with other models.
+    std::shared_ptr<geometrize::TargetCache> m_targetCache; ///< The cache of data derived from the target, kept alive for other models sharing the target, or null if it needs to be looked up again.
     geometrize::Bitmap m_current; ///< The current bitmap.
     double m_lastScore; ///< Score derived from calculating the difference between bitmaps.
+    geometrize::BoundingBox m_dirtyRegion; ///< The bounds of the pixels of the current bitmap changed since the dirty region was last cleared, empty if xMax < xMin.
+    std::shared_ptr<const geometrize::PlanarBitmap> m_planarTarget; ///< Planar copy of the target bitmap used for scoring, from the target cache, or null if it needs to be fetched again.
+    std::unique_ptr<geometrize::PlanarBitmap> m_planarCurrent; ///< Planar copy of the current bitmap used for scoring, kept in step with it, or null if it needs to be made again.
+    bool m_currentOpaque{true}; ///< Whether every pixel of the current bitmap was opaque when its planar copy was made, drawing shapes on an opaque bitmap leaves it opaque.
+    std::unique_ptr<geometrize::BitmapPyramid> m_currentPyramid; ///< Successively halved copies of the current bitmap, kept in step with it, or null if they need to be made again.
+    std::uint32_t m_currentPyramidLevelCount{0U}; ///< The number of levels asked for when the pyramid of the current bitmap was made.
+    std::vector<geometrize::Bitmap> m_buffers; ///< Copies of the current bitmap for custom energy functions to draw on while hill climbing, one per thread, made on first use and kept in step with it.
+    geometrize::ScanlineUndoBuffer m_undoBuffer; ///< The pixels of the current bitmap under the last shape drawn, from before it was drawn, for scoring and rolling back the shape.
     const static std::uint32_t defaultMaxThreads{4};
     std::atomic<std::uint32_t> m_baseRandomSeed; ///< The base value used for seeding the random number generator (the one the user has control over).
     std::atomic<std::uint32_t> m_randomSeedOffset; ///< Seed used for random number generation. Note: incremented by each std::async call used for model stepping.
@@ -221,7 +484,19 @@ private:
 Model::Model(const geometrize::Bitmap& target) : d{std::unique_ptr<Model::ModelImpl>(new Model::ModelImpl(target))}
 {}
 
-Model::Model(const geometrize::Bitmap& target, const geometrize::Bitmap& initial) : d{std::unique_ptr<Model::ModelImpl>(new Model::ModelImpl(target, initial))}
+Model::Model(const geometrize::Bitmap& target, geometrize::Bitmap initial) : d{std::unique_ptr<Model::ModelImpl>(new Model::ModelImpl(target, std::move(initial)))}
+{}
+
+Model::Model(const geometrize::BitmapView& target) : Model(geometrize::Bitmap(target))
+{}
+
+Model::Model(const geometrize::BitmapView& target, geometrize::Bitmap initial) : Model(geometrize::Bitmap(target), std::move(initial))
+{}
+
+Model::Model(const std::shared_ptr<const geometrize::Bitmap>& target) : d{std::unique_ptr<Model::ModelImpl>(new Model::ModelImpl(target))}
+{}
+
+Model::Model(const std::shared_ptr<const geometrize::Bitmap>& target, geometrize::Bitmap initial) : d{std::unique_ptr<Model::ModelImpl>(new Model::ModelImpl(target, std::move(initial)))}
 {}
 
 Model::~Model()
@@ -254,11 +529,63 @@ std::vector<geometrize::ShapeResult> Model::step(
     return d->step(shapeCreator, alpha, shapeCount, maxShapeMutations, maxThreads, energyFunction, addShapePrecondition);
 }
 
+std::vector<geometrize::ShapeResult> Model::step(
+        const geometrize::ShapeTypes types,
+        const std::int32_t xMin,
+        const std::int32_t yMin,
+        const std::int32_t xMax,
+        const std::int32_t yMax,
+        const std::uint8_t alpha,
+        const std::uint32_t shapeCount,
+        const std::uint32_t maxShapeMutations,
+        const std::uint32_t maxThreads,
+        const geometrize::core::EnergyFunction& energyFunction,
+        const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+{
+    return d->step(types, xMin, yMin, xMax, yMax, alpha, shapeCount, maxShapeMutations, maxThreads, energyFunction, addShapePrecondition);
+}
+
+std::vector<geometrize::ShapeResult> Model::step(
+        const geometrize::ShapeSlotCreator& shapeCreator,
+        const std::int32_t xMin,
+        const std::int32_t yMin,
+        const std::int32_t xMax,
+        const std::int32_t yMax,
+        const std::uint8_t alpha,
+        const std::uint32_t shapeCount,
+        const std::uint32_t maxShapeMutations,
+        const std::uint32_t maxThreads,
+        const geometrize::core::EnergyFunction& energyFunction,
+        const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+{
+    return d->step(shapeCreator, xMin, yMin, xMax, yMax, alpha, shapeCount, maxShapeMutations, maxThreads, energyFunction, addShapePrecondition);
+}
+
+std::vector<geometrize::ShapeResult> Model::addShape(std::shared_ptr<geometrize::Shape> shape, geometrize::rgba color, const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+{
+    return d->addShape(shape, color, addShapePrecondition);
+}
+
 geometrize::ShapeResult Model::drawShape(std::shared_ptr<geometrize::Shape> shape, geometrize::rgba color)
 {
     return d->drawShape(shape, color);
 }
 
+void Model::copyLines(const geometrize::Bitmap& source, const std::vector<geometrize::Scanline>& lines)
+{
+    d->copyLines(source, lines);
+}
+
+void Model::currentChanged()
+{
+    d->currentChanged();
+}
+
+const geometrize::BitmapPyramid& Model::getCurrentPyramid(const std::uint32_t levelCount)
+{
+    return d->getCurrentPyramid(levelCount);
+}
+
 geometrize::Bitmap& Model::getTarget()
 {
     return d->getTarget();
@@ -271,7 +598,12 @@ geometrize::Bitmap& Model::getCurrent()
 
 const geometrize::Bitmap& Model::getTarget() const
 {
-    return d->getTarget();
+    return std::as_const(*d).getTarget(); // The non-const overload would take a private copy of a shared target
+}
+
+std::shared_ptr<const geometrize::Bitmap> Model::getSharedTarget() const
+{
+    return d->getSharedTarget();
 }
 
 const geometrize::Bitmap& Model::getCurrent() const
@@ -279,6 +611,16 @@ const geometrize::Bitmap& Model::getCurrent() const
     return d->getCurrent();
 }
 
+geometrize::BoundingBox Model::getDirtyRegion() const
+{
+    return d->getDirtyRegion();
+}
+
+void Model::clearDirtyRegion()
+{
+    d->clearDirtyRegion();
+}
+
 void Model::setSeed(const std::uint32_t seed)
 {
     d->setSeed(seed);
@@ -6,11 +6,14 @@
 #include <vector>
 
 #include "core.h"
+#include "rasterizer/boundingbox.h"
 #include "shaperesult.h"
 
 namespace geometrize
 {
 class Bitmap;
+class BitmapPyramid;
+class BitmapView;
 class Scanline;
 class Shape;
 }
@@ -59,7 +62,37 @@ public:
      * @param target The target bitmap to replicate with shapes.
      * @param initial The starting bitmap.
      */
-    Model(const geometrize::Bitmap& target, const geometrize::Bitmap& initial);
+    Model(const geometrize::Bitmap& target, geometrize::Bitmap initial);
+
+    /**
+     * @brief Model Creates a model that will aim to replicate the target bitmap with shapes, reading the target directly from the memory of the view rather than copying it.
+     * The pixel data of the view must outlive the model.
+     * @param target A view of the target bitmap to replicate with shapes.
+     */
+    Model(const geometrize::BitmapView& target);
+
+    /**
+     * @brief Model Creates a model that will optimize for the target bitmap of the view, starting from the given initial bitmap, without copying the target.
+     * The target bitmap and initial bitmap must be the same size (width and height). The pixel data of the view must outlive the model.
+     * @param target A view of the target bitmap to replicate with shapes.
+     * @param initial The starting bitmap.
+     */
+    Model(const geometrize::BitmapView& target, geometrize::Bitmap initial);
+
+    /**
+     * @brief Model Creates a model that will aim to replicate the target bitmap with shapes, sharing the target rather than copying it.
+     * Many models can share one target, and data derived from the target, such as its average color, is computed once for all of them.
+     * @param target The target bitmap to replicate with shapes, must not be changed while the model uses it.
+     */
+    Model(const std::shared_ptr<const geometrize::Bitmap>& target);
+
+    /**
+     * @brief Model Creates a model that will optimize for the given shared target bitmap, starting from the given initial bitmap.
+     * The target bitmap and initial bitmap must be the same size (width and height).
+     * @param target The target bitmap to replicate with shapes, must not be changed while the model uses it.
+     * @param initial The starting bitmap. Move in a bitmap that maps a writable file to keep the current bitmap in the file, rather than in memory.
+     */
+    Model(const std::shared_ptr<const geometrize::Bitmap>& target, geometrize::Bitmap initial);
     ~Model();
     Model& operator=(const Model&) = delete;
     Model(const Model&) = delete;
@@ -102,6 +135,78 @@ public:
             const geometrize::core::EnergyFunction& energyFunction = nullptr,
             const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition = nullptr);
 
+    /**
+     * @brief step Steps the primitive optimization/fitting algorithm, using shapes of the given types.
+     * Candidate shapes are optimized as plain values rather than shape objects, which avoids allocating memory for every mutation.
+     * If types names exactly one shape type, the step runs a pipeline compiled specifically for that type of shape. ImageRunner uses this step when no shape creator is given.
+     * Gives the same results as stepping with a default shape creator for the same types and area.
+     * @param types The types of shape to use.
+     * @param xMin The minimum x coordinate of the shapes created.
+     * @param yMin The minimum y coordinate of the shapes created.
+     * @param xMax The maximum x coordinate of the shapes created.
+     * @param yMax The maximum y coordinate of the shapes created.
+     * @param alpha The alpha of the shape.
+     * @param shapeCount The number of random shapes to generate (only 1 is chosen in the end).
+     * @param maxShapeMutations The maximum number of times to mutate each random shape.
+     * @param maxThreads The maximum number of threads to use during this step.
+     * @param energyFunction An optional function to calculate the energy (if unspecified a default implementation is used).
+     * @param addShapePrecondition An optional function to determine whether to accept a shape (if unspecified a default implementation is used).
+     * @return A vector containing data about the shapes added to the model in this step. This may be empty if no shape that improved the image could be found.
+     */
+    std::vector<geometrize::ShapeResult> step(
+            geometrize::ShapeTypes types,
+            std::int32_t xMin,
+            std::int32_t yMin,
+            std::int32_t xMax,
+            std::int32_t yMax,
+            std::uint8_t alpha,
+            std::uint32_t shapeCount,
+            std::uint32_t maxShapeMutations,
+            std::uint32_t maxThreads,
+            const geometrize::core::EnergyFunction& energyFunction = nullptr,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition = nullptr);
+
+    /**
+     * @brief step Steps the primitive optimization/fitting algorithm, taking the random candidate shapes from a per-thread shape arena rather than allocating each one.
+     * Gives the same results as stepping with the default shape creator when used with the default shape slot creator for the same types and area.
+     * @param shapeCreator A function that will take the shapes out of the arena.
+     * @param xMin The minimum x coordinate of the shapes created.
+     * @param yMin The minimum y coordinate of the shapes created.
+     * @param xMax The maximum x coordinate of the shapes created.
+     * @param yMax The maximum y coordinate of the shapes created.
+     * @param alpha The alpha of the shape.
+     * @param shapeCount The number of random shapes to generate (only 1 is chosen in the end).
+     * @param maxShapeMutations The maximum number of times to mutate each random shape.
+     * @param maxThreads The maximum number of threads to use during this step.
+     * @param energyFunction An optional function to calculate the energy (if unspecified a default implementation is used).
+     * @param addShapePrecondition An optional function to determine whether to accept a shape (if unspecified a default implementation is used).
+     * @return A vector containing data about the shapes added to the model in this step. This may be empty if no shape that improved the image could be found.
+     */
+    std::vector<geometrize::ShapeResult> step(
+            const geometrize::ShapeSlotCreator& shapeCreator,
+            std::int32_t xMin,
+            std::int32_t yMin,
+            std::int32_t xMax,
+            std::int32_t yMax,
+            std::uint8_t alpha,
+            std::uint32_t shapeCount,
+            std::uint32_t maxShapeMutations,
+            std::uint32_t maxThreads,
+            const geometrize::core::EnergyFunction& energyFunction = nullptr,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition = nullptr);
+
+    /**
+     * @brief addShape Draws a shape on the model if it is accepted, as step does with the best shape it finds. Typically used to add shapes found elsewhere, such as on a smaller copy of the image.
+     * @param shape The shape to add.
+     * @param color The color (including alpha) of the shape.
+     * @param addShapePrecondition An optional function to determine whether to accept the shape (if unspecified the shape is accepted if it improves the image).
+     * @return A vector containing data about the shape added to the model, or an empty vector if the shape was rejected and the model left unchanged.
+     */
+    std::vector<geometrize::ShapeResult> addShape(
+            std::shared_ptr<geometrize::Shape> shape,
+            geometrize::rgba color,
+            const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition = nullptr);
+
     /**
      * @brief drawShape Draws a shape on the model. Typically used when to manually add a shape to the image (e.g. when setting an initial background).
      * NOTE this unconditionally draws the shape, even if it increases the difference between the source and target image.
@@ -112,13 +217,34 @@ public:
     geometrize::ShapeResult drawShape(std::shared_ptr<geometrize::Shape> shape, geometrize::rgba color);
 
     /**
-     * @brief getCurrent Gets the current bitmap.
+     * @brief copyLines Copies the pixels under the given scanlines from a bitmap the size of the model to the current bitmap, updating the score as drawing a shape does.
+     * Typically used to bring the current bitmap back in step with another copy of the image, such as a shrunk copy of a larger image.
+     * @param source The bitmap to copy the pixels from.
+     * @param lines The scanlines to copy, which must not overlap.
+     */
+    void copyLines(const geometrize::Bitmap& source, const std::vector<geometrize::Scanline>& lines);
+
+    /**
+     * @brief getCurrent Gets the current bitmap. If its pixels are changed through the reference, call currentChanged() afterwards.
      * @return The current bitmap.
      */
     geometrize::Bitmap& getCurrent();
 
     /**
-     * @brief getTarget Gets the target bitmap.
+     * @brief currentChanged Tells the model that the pixels of the current bitmap were changed through getCurrent(), so it recalculates the score and the copies of the bitmap it keeps for scoring.
+     * The whole bitmap is added to the dirty region.
+     */
+    void currentChanged();
+
+    /**
+     * @brief getCurrentPyramid Gets successively halved copies of the current bitmap, making them on first use and keeping them in step with it as shapes are drawn.
+     * @param levelCount The number of levels needed, the pyramid is made again if it has fewer.
+     * @return The pyramid of the current bitmap, which may have fewer levels than asked for if the bitmap is very small.
+     */
+    const geometrize::BitmapPyramid& getCurrentPyramid(std::uint32_t levelCount);
+
+    /**
+     * @brief getTarget Gets the target bitmap. If the target is shared with other models, the model first takes a copy of its own, so changes do not affect them.
      * @return The target bitmap.
      */
     geometrize::Bitmap& getTarget();
@@ -135,6 +261,24 @@ public:
      */
     const geometrize::Bitmap& getTarget() const;
 
+    /**
+     * @brief getSharedTarget Gets a shared pointer to the target bitmap, which other models can be created from without copying the target.
+     * @return The target bitmap.
+     */
+    std::shared_ptr<const geometrize::Bitmap> getSharedTarget() const;
+
+    /**
+     * @brief getDirtyRegion Gets the bounds of the pixels of the current bitmap that changed since the dirty region was last cleared, so consumers can copy just that part of it.
+     * The region grows to cover each shape that is added or drawn, and covers the whole bitmap when the model is created or reset, or when currentChanged() is called.
+     * @return The dirty region, which is empty (xMax < xMin) if nothing changed.
+     */
+    geometrize::BoundingBox getDirtyRegion() const;
+
+    /**
+     * @brief clearDirtyRegion Empties the dirty region, typically after the changed pixels have been copied.
+     */
+    void clearDirtyRegion();
+
     /**
      * @brief setSeed Sets the seed that the random number generators of this model use. Note that the model also uses an internal seed offset which is incremented when the model is stepped.
      * @param seed The random number generator seed.
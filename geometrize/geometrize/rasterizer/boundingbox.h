@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace geometrize
+{
+
+/**
+ * @brief The BoundingBox struct represents an axis-aligned rectangle in pixel coordinates. The minimum and maximum coordinates are both inclusive.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+struct BoundingBox
+{
+    std::int32_t xMin; ///< The leftmost x-coordinate.
+    std::int32_t yMin; ///< The topmost y-coordinate.
+    std::int32_t xMax; ///< The rightmost x-coordinate.
+    std::int32_t yMax; ///< The bottommost y-coordinate.
+};
+
+}
@@ -3,10 +3,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
-#include <map>
-#include <set>
 #include <utility>
 #include <vector>
 
@@ -21,13 +20,286 @@
 #include "../shape/rectangle.h"
 #include "../shape/rotatedellipse.h"
 #include "../shape/rotatedrectangle.h"
+#include "../shape/shapevalue.h"
 #include "../shape/triangle.h"
+#include "boundingbox.h"
 #include "scanline.h"
+#include "scanlineset.h"
+#include "spanbatch.h"
 
-namespace geometrize
+namespace
 {
 
-std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRectangle& r)
+/**
+ * @brief scanlineLess Orders scanlines by row, then by leftmost x-coordinate.
+ */
+bool scanlineLess(const geometrize::Scanline& a, const geometrize::Scanline& b)
+{
+    return a.y < b.y || (a.y == b.y && a.x1 < b.x1);
+}
+
+/**
+ * @brief sortScanlines Returns a copy of the given scanlines, sorted by row and then by leftmost x-coordinate.
+ */
+std::vector<geometrize::Scanline> sortScanlines(const std::vector<geometrize::Scanline>& lines)
+{
+    std::vector<geometrize::Scanline> sorted{lines};
+    std::sort(sorted.begin(), sorted.end(), scanlineLess);
+    return sorted;
+}
+
+/**
+ * @brief getBounds Gets the exact bounding box of a non-empty set of scanlines.
+ */
+geometrize::BoundingBox getBounds(const std::vector<geometrize::Scanline>& lines)
+{
+    assert(!lines.empty());
+    geometrize::BoundingBox bounds{lines.front().x1, lines.front().y, lines.front().x2, lines.front().y};
+    for(const geometrize::Scanline& line : lines) {
+        bounds.xMin = (std::min)(bounds.xMin, line.x1);
+        bounds.yMin = (std::min)(bounds.yMin, line.y);
+        bounds.xMax = (std::max)(bounds.xMax, line.x2);
+        bounds.yMax = (std::max)(bounds.yMax, line.y);
+    }
+    return bounds;
+}
+
+/**
+ * @brief getBounds Gets the bounding box of the given points, with the point coordinates truncated the same way as the rasterizer does.
+ * Works with any non-empty container of points with first and second members.
+ */
+template<typename Points> geometrize::BoundingBox getBounds(const Points& points)
+{
+    assert(!points.empty());
+    const auto& front{*points.begin()};
+    geometrize::BoundingBox bounds{static_cast<std::int32_t>(front.first), static_cast<std::int32_t>(front.second), static_cast<std::int32_t>(front.first), static_cast<std::int32_t>(front.second)};
+    for(const auto& point : points) {
+        const std::int32_t x{static_cast<std::int32_t>(point.first)};
+        const std::int32_t y{static_cast<std::int32_t>(point.second)};
+        bounds.xMin = (std::min)(bounds.xMin, x);
+        bounds.yMin = (std::min)(bounds.yMin, y);
+        bounds.xMax = (std::max)(bounds.xMax, x);
+        bounds.yMax = (std::max)(bounds.yMax, y);
+    }
+    return bounds;
+}
+
+/**
+ * @brief clipBounds Clips bounds to the area that rasterized scanlines are restricted to, where xMax and yMax are exclusive.
+ */
+geometrize::BoundingBox clipBounds(const geometrize::BoundingBox& bounds, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return geometrize::BoundingBox{(std::max)(bounds.xMin, xMin), (std::max)(bounds.yMin, yMin), (std::min)(bounds.xMax, xMax - 1), (std::min)(bounds.yMax, yMax - 1)};
+}
+
+bool isEmpty(const geometrize::BoundingBox& b)
+{
+    return b.xMin > b.xMax || b.yMin > b.yMax;
+}
+
+bool intersects(const geometrize::BoundingBox& a, const geometrize::BoundingBox& b)
+{
+    return !isEmpty(a) && !isEmpty(b) && a.xMin <= b.xMax && a.xMax >= b.xMin && a.yMin <= b.yMax && a.yMax >= b.yMin;
+}
+
+bool contains(const geometrize::BoundingBox& container, const geometrize::BoundingBox& containee)
+{
+    return container.xMin <= containee.xMin && container.xMax >= containee.xMax && container.yMin <= containee.yMin && container.yMax >= containee.yMax;
+}
+
+/**
+ * @brief forEachLinePoint Bresenham's line algorithm. Calls the given function for each point on the line.
+ */
+template<typename F> void forEachLinePoint(std::int32_t x1, std::int32_t y1, const std::int32_t x2, const std::int32_t y2, F f)
+{
+    std::int32_t dx{x2 - x1};
+    const std::int8_t ix{static_cast<std::int8_t>((dx > 0) - (dx < 0))};
+    dx = std::abs(dx) << 1;
+
+    std::int32_t dy{y2 - y1};
+    const std::int8_t iy{static_cast<std::int8_t>((dy > 0) - (dy < 0))};
+    dy = std::abs(dy) << 1;
+
+    f(x1, y1);
+
+    if (dx >= dy) {
+        std::int32_t error(dy - (dx >> 1));
+        while (x1 != x2) {
+            if (error >= 0 && (error || (ix > 0))) {
+                error -= dx;
+                y1 += iy;
+            }
+
+            error += dy;
+            x1 += ix;
+
+            f(x1, y1);
+        }
+    } else {
+        std::int32_t error(dx - (dy >> 1));
+        while (y1 != y2) {
+            if (error >= 0 && (error || (iy > 0))) {
+                error -= dy;
+                x1 += ix;
+            }
+
+            error += dx;
+            y1 += iy;
+
+            f(x1, y1);
+        }
+    }
+}
+
+/**
+ * @brief addClippedScanline Adds a scanline clipped to the given bounds, discarding it if it lies outside them.
+ */
+void addClippedScanline(std::vector<geometrize::Scanline>& lines, const std::int32_t y, const std::int32_t x1, const std::int32_t x2, const geometrize::BoundingBox& clip)
+{
+    if(y < clip.yMin || y > clip.yMax || x2 < clip.xMin || x1 > clip.xMax) {
+        return;
+    }
+    lines.push_back(geometrize::Scanline(y, (std::max)(x1, clip.xMin), (std::min)(x2, clip.xMax)));
+}
+
+/**
+ * @brief appendLineSpans Walks the line between the given points, adding a single clipped scanline for each run of pixels on a row.
+ */
+void appendLineSpans(const std::int32_t x1, const std::int32_t y1, const std::int32_t x2, const std::int32_t y2, const geometrize::BoundingBox& clip, std::vector<geometrize::Scanline>& spans)
+{
+    if(!intersects(clip, geometrize::BoundingBox{(std::min)(x1, x2), (std::min)(y1, y2), (std::max)(x1, x2), (std::max)(y1, y2)})) {
+        return;
+    }
+
+    std::int32_t runY{y1};
+    std::int32_t runX1{x1};
+    std::int32_t runX2{x1};
+    forEachLinePoint(x1, y1, x2, y2, [&](const std::int32_t x, const std::int32_t y) {
+        if(y == runY) {
+            runX1 = (std::min)(runX1, x);
+            runX2 = (std::max)(runX2, x);
+        } else {
+            addClippedScanline(spans, runY, runX1, runX2, clip);
+            runY = y;
+            runX1 = x;
+            runX2 = x;
+        }
+    });
+    addClippedScanline(spans, runY, runX1, runX2, clip);
+}
+
+/**
+ * @brief walkEdgeRuns Walks the line between the given points the same way as appendLineSpans and scanlinesForPolygon do, recording one unclipped run of pixels per row.
+ * Only rows within the given range are recorded, and the runs are stored in ascending row order, so the run for a row can be looked up by its offset from the first run.
+ */
+void walkEdgeRuns(const std::int32_t x1, const std::int32_t y1, const std::int32_t x2, const std::int32_t y2, const std::int32_t yMin, const std::int32_t yMax, std::vector<geometrize::Scanline>& runs)
+{
+    runs.clear();
+    if((std::max)(y1, y2) < yMin || (std::min)(y1, y2) > yMax) {
+        return;
+    }
+
+    std::int32_t runY{y1};
+    std::int32_t runX1{x1};
+    std::int32_t runX2{x1};
+    forEachLinePoint(x1, y1, x2, y2, [&](const std::int32_t x, const std::int32_t y) {
+        if(y == runY) {
+            runX1 = (std::min)(runX1, x);
+            runX2 = (std::max)(runX2, x);
+        } else {
+            if(runY >= yMin && runY <= yMax) {
+                runs.push_back(geometrize::Scanline(runY, runX1, runX2));
+            }
+            runY = y;
+            runX1 = x;
+            runX2 = x;
+        }
+    });
+    if(runY >= yMin && runY <= yMax) {
+        runs.push_back(geometrize::Scanline(runY, runX1, runX2));
+    }
+
+    if(y2 < y1) {
+        std::reverse(runs.begin(), runs.end());
+    }
+}
+
+/**
+ * @brief mergeSpans Sorts the given scanlines and merges the ones that overlap or touch on the same row, so that no pixel is covered twice.
+ */
+void mergeSpans(std::vector<geometrize::Scanline>& spans)
+{
+    if(spans.empty()) {
+        return;
+    }
+
+    std::sort(spans.begin(), spans.end(), scanlineLess);
+
+    std::size_t last{0};
+    for(std::size_t i = 1; i < spans.size(); i++) {
+        geometrize::Scanline& prev{spans[last]};
+        const geometrize::Scanline& span{spans[i]};
+        if(span.y == prev.y && span.x1 <= prev.x2 + 1) {
+            prev.x2 = (std::max)(prev.x2, span.x2);
+        } else {
+            spans[++last] = span;
+        }
+    }
+    spans.resize(last + 1U);
+}
+
+/**
+ * @brief drawSpans Blends the given scanlines onto an image, shared by the scanline vector and scanline set versions of drawLines.
+ */
+template<typename Lines> void drawSpans(geometrize::Bitmap& image, const geometrize::rgba color, const Lines& lines)
+{
+    // Convert the non-premultiplied color to alpha-premultiplied 16-bits per channel RGBA
+    // In other words, scale the rgb color components by the alpha component
+    std::uint32_t sr{color.r};
+    sr |= sr << 8;
+    sr *= color.a;
+    sr /= UINT8_MAX;
+    std::uint32_t sg{color.g};
+    sg |= sg << 8;
+    sg *= color.a;
+    sg /= UINT8_MAX;
+    std::uint32_t sb{color.b};
+    sb |= sb << 8;
+    sb *= color.a;
+    sb /= UINT8_MAX;
+    std::uint32_t sa{color.a};
+    sa |= sa << 8;
+
+    const std::uint32_t m{UINT16_MAX};
+    const std::uint32_t aa{(m - sa) * 257U};
+
+    geometrize::forEachSpan(lines, [&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        std::uint8_t* const d{image.writableSpan(y, x1, x2)};
+        const std::size_t spanSize{static_cast<std::size_t>(x2 - x1 + 1) * 4U};
+        for(std::size_t i = 0; i < spanSize; i += 4U) {
+            d[i] = static_cast<std::uint8_t>(((d[i] * aa + sr * m) / m) >> 8);
+            d[i + 1U] = static_cast<std::uint8_t>(((d[i + 1U] * aa + sg * m) / m) >> 8);
+            d[i + 2U] = static_cast<std::uint8_t>(((d[i + 2U] * aa + sb * m) / m) >> 8);
+            d[i + 3U] = static_cast<std::uint8_t>(((d[i + 3U] * aa + sa * m) / m) >> 8);
+        }
+    });
+}
+
+/**
+ * @brief copySpans Copies the source pixels under the given scanlines to the destination, shared by the scanline vector and scanline set versions of copyLines.
+ */
+template<typename Lines> void copySpans(geometrize::Bitmap& destination, const geometrize::Bitmap& source, const Lines& lines)
+{
+    geometrize::forEachSpan(lines, [&](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        const std::uint8_t* const s{source.span(y, x1, x2)};
+        std::copy(s, s + static_cast<std::size_t>(x2 - x1 + 1) * 4U, destination.writableSpan(y, x1, x2));
+    });
+}
+
+/**
+ * @brief cornerPoints Gets the corner points of the given rotated rectangle.
+ */
+template<typename T> std::vector<std::pair<float, float>> cornerPoints(const T& r)
 {
     const float x1{(std::fmin)(r.m_x1, r.m_x2)};
     const float x2{(std::fmax)(r.m_x1, r.m_x2)};
@@ -54,8 +326,11 @@ std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRe
     return {ul, ur, br, bl};
 }
 
-std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize::RotatedEllipse& e, const std::size_t numPoints)
-{    
+/**
+ * @brief pointsOnRotatedEllipse Calculates a number of points on the given rotated ellipse.
+ */
+template<typename T> std::vector<std::pair<float, float>> pointsOnRotatedEllipse(const T& e, const std::size_t numPoints)
+{
     std::vector<std::pair<float, float>> points;
     const float rads{e.m_angle * (3.141f / 180.0f)};
     const float co{std::cos(rads)};
@@ -71,124 +346,647 @@ std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize:
     return points;
 }
 
-void drawLines(geometrize::Bitmap& image, const geometrize::rgba color, const std::vector<geometrize::Scanline>& lines)
+/**
+ * @brief pointsOnQuadraticBezier Flattens the given quadratic bezier curve into a polyline.
+ */
+template<typename T> std::vector<std::pair<float, float>> pointsOnQuadraticBezier(const T& s, const float tolerance)
+{
+    // The curve is p(t) = a * t^2 + b * t + c. Splitting it into n equal steps in t keeps each chord within |a| / (4 * n^2) of the curve
+    const float ax{s.m_x1 - 2.0f * s.m_cx + s.m_x2};
+    const float ay{s.m_y1 - 2.0f * s.m_cy + s.m_y2};
+    const float bx{2.0f * (s.m_cx - s.m_x1)};
+    const float by{2.0f * (s.m_cy - s.m_y1)};
+
+    const float deviation{std::sqrt(ax * ax + ay * ay)};
+    const std::uint32_t segmentCount{(std::max)(1U, static_cast<std::uint32_t>(std::ceil(std::sqrt(deviation / (4.0f * tolerance)))))};
+
+    // Evaluate the points by forward differencing
+    const float h{1.0f / static_cast<float>(segmentCount)};
+    float x{s.m_x1};
+    float y{s.m_y1};
+    float dx{ax * h * h + bx * h};
+    float dy{ay * h * h + by * h};
+    const float ddx{2.0f * ax * h * h};
+    const float ddy{2.0f * ay * h * h};
+
+    std::vector<std::pair<float, float>> points;
+    points.reserve(segmentCount + 1U);
+    points.push_back(std::make_pair(x, y));
+    for(std::uint32_t i = 1; i < segmentCount; i++) {
+        x += dx;
+        y += dy;
+        dx += ddx;
+        dy += ddy;
+        points.push_back(std::make_pair(x, y));
+    }
+    points.push_back(std::make_pair(s.m_x2, s.m_y2)); // Avoid accumulated error at the end of the curve
+
+    return points;
+}
+
+template<typename T> geometrize::BoundingBox boundsRectangle(const T& s)
+{
+    return geometrize::BoundingBox{
+        static_cast<std::int32_t>((std::fmin)(s.m_x1, s.m_x2)),
+        static_cast<std::int32_t>((std::fmin)(s.m_y1, s.m_y2)),
+        static_cast<std::int32_t>((std::fmax)(s.m_x1, s.m_x2)),
+        static_cast<std::int32_t>((std::fmax)(s.m_y1, s.m_y2))
+    };
+}
+
+template<typename T> geometrize::BoundingBox boundsRotatedRectangle(const T& s)
+{
+    return ::getBounds(cornerPoints(s));
+}
+
+template<typename T> geometrize::BoundingBox boundsTriangle(const T& s)
+{
+    return ::getBounds(std::vector<std::pair<float, float>>{{s.m_x1, s.m_y1}, {s.m_x2, s.m_y2}, {s.m_x3, s.m_y3}});
+}
+
+template<typename T> geometrize::BoundingBox boundsEllipse(const T& s)
+{
+    // Padded by a pixel as the rasterizer computes the horizontal extents in floating point
+    const std::int32_t x{static_cast<std::int32_t>(s.m_x)};
+    const std::int32_t y{static_cast<std::int32_t>(s.m_y)};
+    const std::int32_t rx{static_cast<std::int32_t>(std::ceil(s.m_rx)) + 1};
+    const std::int32_t ry{static_cast<std::int32_t>(std::ceil(s.m_ry))};
+    return geometrize::BoundingBox{x - rx, y - ry, x + rx, y + ry};
+}
+
+template<typename T> geometrize::BoundingBox boundsRotatedEllipse(const T& s)
+{
+    // Half-extents of the rotated ellipse, padded by a pixel as the rasterizer works in floating point
+    const float rads{s.m_angle * (3.141f / 180.0f)};
+    const float co{std::cos(rads)};
+    const float si{std::sin(rads)};
+    const float ex{std::sqrt(s.m_rx * s.m_rx * co * co + s.m_ry * s.m_ry * si * si)};
+    const float ey{std::sqrt(s.m_rx * s.m_rx * si * si + s.m_ry * s.m_ry * co * co)};
+    return geometrize::BoundingBox{
+        static_cast<std::int32_t>(std::floor(s.m_x - ex)) - 1,
+        static_cast<std::int32_t>(std::floor(s.m_y - ey)) - 1,
+        static_cast<std::int32_t>(std::ceil(s.m_x + ex)) + 1,
+        static_cast<std::int32_t>(std::ceil(s.m_y + ey)) + 1
+    };
+}
+
+template<typename T> geometrize::BoundingBox boundsCircle(const T& s)
+{
+    const std::int32_t x{static_cast<std::int32_t>(s.m_x)};
+    const std::int32_t y{static_cast<std::int32_t>(s.m_y)};
+    const std::int32_t r{static_cast<std::int32_t>(s.m_r)};
+    return geometrize::BoundingBox{x - r, y - r, x + r, y + r};
+}
+
+template<typename T> geometrize::BoundingBox boundsLine(const T& s)
+{
+    return ::getBounds(std::vector<std::pair<float, float>>{{s.m_x1, s.m_y1}, {s.m_x2, s.m_y2}});
+}
+
+template<typename T> geometrize::BoundingBox boundsQuadraticBezier(const T& s)
+{
+    // The curve lies within the convex hull of its control points
+    // Padded by a pixel as points on the curve are evaluated in floating point
+    const geometrize::BoundingBox hull{::getBounds(std::vector<std::pair<float, float>>{{s.m_x1, s.m_y1}, {s.m_cx, s.m_cy}, {s.m_x2, s.m_y2}})};
+    return geometrize::BoundingBox{hull.xMin - 1, hull.yMin - 1, hull.xMax + 1, hull.yMax + 1};
+}
+
+template<typename T> geometrize::BoundingBox boundsPolyline(const T& s)
+{
+    if(s.m_points.empty()) {
+        return geometrize::BoundingBox{0, 0, -1, -1};
+    }
+    return ::getBounds(s.m_points);
+}
+
+/**
+ * @brief The SpanTemplateCache class is a small least recently used cache of span templates, the half-width of each row of a circle or axis-aligned ellipse
+ * by its distance from the centre row. Shapes with the same radii always have the same template, just translated, so moving one needs no per-row arithmetic.
+ */
+class SpanTemplateCache
+{
+public:
+    static const std::size_t MAX_TEMPLATES{32}; ///< The maximum number of templates kept.
+
+    /**
+     * @brief get Gets the template for the given radii, making it with the given function if it is not in the cache.
+     * @param rx The x-radius.
+     * @param ry The y-radius.
+     * @param makeHalfWidths A function that fills in a template, with the signature void(std::vector<std::int32_t>& halfWidths).
+     * @return The half-widths of the rows. The reference is valid until the next call, the data it holds until MAX_TEMPLATES more templates have been made,
+     * as the vectors holding the templates are only moved around within the cache.
+     */
+    template<typename F> const std::vector<std::int32_t>& get(const float rx, const float ry, F makeHalfWidths)
+    {
+        // Templates are kept in order of use, most recent first
+        for(std::size_t i = 0; i < m_templates.size(); i++) {
+            if(m_templates[i].rx == rx && m_templates[i].ry == ry) {
+                std::rotate(m_templates.begin(), m_templates.begin() + static_cast<std::ptrdiff_t>(i), m_templates.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+                return m_templates.front().halfWidths;
+            }
+        }
+
+        // Reuse the least recently used template once the cache is full
+        if(m_templates.size() < MAX_TEMPLATES) {
+            m_templates.emplace_back();
+        }
+        std::rotate(m_templates.begin(), m_templates.end() - 1, m_templates.end());
+        Template& t{m_templates.front()};
+        t.rx = rx;
+        t.ry = ry;
+        t.halfWidths.clear();
+        makeHalfWidths(t.halfWidths);
+        return t.halfWidths;
+    }
+
+private:
+    struct Template
+    {
+        float rx; ///< The x-radius.
+        float ry; ///< The y-radius.
+        std::vector<std::int32_t> halfWidths; ///< The half-width of each row, by distance from the centre row.
+    };
+
+    std::vector<Template> m_templates; ///< The cached templates, most recently used first.
+};
+
+thread_local static SpanTemplateCache circleSpanTemplates; ///< Span templates for circles, keyed by the (truncated) radius.
+thread_local static SpanTemplateCache ellipseSpanTemplates; ///< Span templates for axis-aligned ellipses, keyed by their radii.
+static_assert(geometrize::SpanBatch::MAX_SHAPES <= SpanTemplateCache::MAX_TEMPLATES, "The span templates of a whole batch of shapes must fit in the cache");
+
+/**
+ * @brief circleHalfWidths Gets the span template for circles of the given (truncated) radius, for each row from the centre row to the edge.
+ */
+const std::vector<std::int32_t>& circleHalfWidths(const std::int32_t r)
+{
+    return circleSpanTemplates.get(static_cast<float>(r), static_cast<float>(r), [r](std::vector<std::int32_t>& widths) {
+        for(std::int32_t dy = 0; dy <= r; dy++) {
+            // Find the half-width of the row, the largest dx for which dx * dx + dy * dy <= r * r
+            const std::int32_t squaredWidth{r * r - dy * dy};
+            std::int32_t dx{static_cast<std::int32_t>(std::sqrt(static_cast<double>(squaredWidth)))};
+            while(dx * dx > squaredWidth) {
+                dx--;
+            }
+            while((dx + 1) * (dx + 1) <= squaredWidth) {
+                dx++;
+            }
+            widths.push_back(dx);
+        }
+    });
+}
+
+/**
+ * @brief ellipseHalfWidths Gets the span template for axis-aligned ellipses with the radii of the given one, for each row from the centre row to the edge.
+ */
+template<typename T> const std::vector<std::int32_t>& ellipseHalfWidths(const T& s)
+{
+    return ellipseSpanTemplates.get(s.m_rx, s.m_ry, [&s](std::vector<std::int32_t>& widths) {
+        const float aspect{static_cast<float>(s.m_rx) / static_cast<float>(s.m_ry)};
+        for(std::int32_t dy = 0; dy < s.m_ry; dy++) {
+            widths.push_back(static_cast<std::int32_t>(std::sqrt(s.m_ry * s.m_ry - dy * dy) * aspect));
+        }
+    });
+}
+
+/**
+ * @brief rasterizeBatch Rasterizes a batch of shapes together into a span batch, working out the spans of every shape on a row before moving to the next row.
+ * @param rows Gets the first and last rows a shape covers before clipping, with the signature void(std::size_t shape, std::int32_t& first, std::int32_t& last).
+ * @param span Gets the span of a shape on one of its rows before clipping, with the signature void(std::size_t shape, std::int32_t y, std::int32_t& x1, std::int32_t& x2).
+ */
+template<typename Rows, typename Span> void rasterizeBatch(const std::size_t count, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax,
+                                                           geometrize::SpanBatch& batch, Rows rows, Span span)
+{
+    assert(count <= geometrize::SpanBatch::MAX_SHAPES);
+
+    std::int32_t first[geometrize::SpanBatch::MAX_SHAPES]{};
+    std::int32_t last[geometrize::SpanBatch::MAX_SHAPES]{};
+    batch.shapeCount = count;
+    batch.yMin = yMax;
+    batch.yMax = yMin - 1;
+    for(std::size_t k = 0; k < count; k++) {
+        rows(k, first[k], last[k]);
+        first[k] = (std::max)(first[k], yMin);
+        last[k] = (std::min)(last[k], yMax - 1);
+        if(first[k] <= last[k]) {
+            batch.yMin = (std::min)(batch.yMin, first[k]);
+            batch.yMax = (std::max)(batch.yMax, last[k]);
+        }
+    }
+    if(batch.yMax < batch.yMin) {
+        batch.x1.clear();
+        batch.x2.clear();
+        return;
+    }
+
+    const std::size_t size{static_cast<std::size_t>(batch.yMax - batch.yMin + 1) * count};
+    batch.x1.resize(size);
+    batch.x2.resize(size);
+    std::int32_t* x1s{batch.x1.data()};
+    std::int32_t* x2s{batch.x2.data()};
+    for(std::int32_t y = batch.yMin; y <= batch.yMax; y++, x1s += count, x2s += count) {
+        for(std::size_t k = 0; k < count; k++) {
+            std::int32_t x1{0};
+            std::int32_t x2{-1};
+            if(y >= first[k] && y <= last[k]) {
+                span(k, y, x1, x2);
+            }
+            x1s[k] = (std::max)(x1, xMin);
+            x2s[k] = (std::min)(x2, xMax - 1);
+        }
+    }
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeRectangle(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> lines;
+
+    const geometrize::BoundingBox bounds{clipBounds(boundsRectangle(s), xMin, yMin, xMax, yMax)};
+    if(isEmpty(bounds)) {
+        return lines;
+    }
+
+    lines.reserve(static_cast<std::size_t>(bounds.yMax - bounds.yMin) + 1U);
+    for(std::int32_t y = bounds.yMin; y <= bounds.yMax; y++) {
+        lines.push_back(geometrize::Scanline(y, bounds.xMin, bounds.xMax));
+    }
+    return lines;
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeRotatedRectangle(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return geometrize::scanlinesForPolygon(cornerPoints(s), xMin, yMin, xMax, yMax);
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeTriangle(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return geometrize::scanlinesForPolygon({
+        {static_cast<std::int32_t>(s.m_x1), static_cast<std::int32_t>(s.m_y1)},
+        {static_cast<std::int32_t>(s.m_x2), static_cast<std::int32_t>(s.m_y2)},
+        {static_cast<std::int32_t>(s.m_x3), static_cast<std::int32_t>(s.m_y3)}}, xMin, yMin, xMax, yMax);
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeEllipse(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> lines;
+
+    const geometrize::BoundingBox clip{xMin, yMin, xMax - 1, yMax - 1};
+    if(isEmpty(clipBounds(boundsEllipse(s), xMin, yMin, xMax, yMax))) {
+        return lines;
+    }
+
+    const std::vector<std::int32_t>& halfWidths{ellipseHalfWidths(s)};
+    const std::int32_t y{static_cast<std::int32_t>(s.m_y)};
+
+    // Only visit the row offsets where at least one of the two mirrored rows is visible
+    const std::int32_t dyMin{(std::max)(0, (std::max)(yMin - y, y - (yMax - 1)))};
+    const std::int32_t dyMax{(std::max)(yMax - 1 - y, y - yMin)};
+
+    for (std::int32_t dy = dyMin; dy < s.m_ry && dy <= dyMax; dy++) {
+        const std::int32_t y1{y - dy};
+        const std::int32_t y2{y + dy};
+
+        const std::int32_t v{halfWidths[static_cast<std::size_t>(dy)]};
+        const std::int32_t x1{static_cast<std::int32_t>(s.m_x) - v};
+        const std::int32_t x2{static_cast<std::int32_t>(s.m_x) + v};
+
+        addClippedScanline(lines, y1, x1, x2, clip);
+        if (dy > 0) {
+            addClippedScanline(lines, y2, x1, x2, clip);
+        }
+    }
+
+    return lines;
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeRotatedEllipse(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    const std::uint32_t pointCount{20};
+    const std::vector<std::pair<float, float>> points{pointsOnRotatedEllipse(s, pointCount)};
+    return geometrize::scanlinesForPolygon(points, xMin, yMin, xMax, yMax);
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeCircle(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> lines;
+
+    const geometrize::BoundingBox clip{xMin, yMin, xMax - 1, yMax - 1};
+    const geometrize::BoundingBox bounds{clipBounds(boundsCircle(s), xMin, yMin, xMax, yMax)};
+    if(isEmpty(bounds)) {
+        return lines;
+    }
+
+    const std::int32_t x{static_cast<std::int32_t>(s.m_x)};
+    const std::int32_t y{static_cast<std::int32_t>(s.m_y)};
+    const std::int32_t r{static_cast<std::int32_t>(s.m_r)};
+    const std::vector<std::int32_t>& halfWidths{circleHalfWidths(r)};
+
+    lines.reserve(static_cast<std::size_t>(bounds.yMax - bounds.yMin) + 1U);
+    for(std::int32_t fy = bounds.yMin; fy <= bounds.yMax; fy++) {
+        const std::int32_t dx{halfWidths[static_cast<std::size_t>(std::abs(fy - y))]};
+        addClippedScanline(lines, fy, x - dx, x + dx, clip);
+    }
+
+    return lines;
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeLine(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> lines;
+    appendLineSpans(static_cast<std::int32_t>(s.m_x1), static_cast<std::int32_t>(s.m_y1), static_cast<std::int32_t>(s.m_x2), static_cast<std::int32_t>(s.m_y2),
+                    geometrize::BoundingBox{xMin, yMin, xMax - 1, yMax - 1}, lines);
+    return lines;
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizeQuadraticBezier(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> scanlines;
+
+    const geometrize::BoundingBox clip{xMin, yMin, xMax - 1, yMax - 1};
+    if(!intersects(clip, boundsQuadraticBezier(s))) {
+        return scanlines;
+    }
+
+    const std::vector<std::pair<float, float>> points{pointsOnQuadraticBezier(s, geometrize::QUADRATIC_BEZIER_FLATNESS_TOLERANCE)};
+    for(std::size_t i = 0; i < points.size() - 1; i++) {
+        appendLineSpans(static_cast<std::int32_t>(points[i].first), static_cast<std::int32_t>(points[i].second),
+                        static_cast<std::int32_t>(points[i + 1].first), static_cast<std::int32_t>(points[i + 1].second), clip, scanlines);
+    }
+
+    // Prevent scanline overlap, it messes up the energy functions that rely on the scanlines not intersecting themselves
+    mergeSpans(scanlines);
+
+    return scanlines;
+}
+
+template<typename T> std::vector<geometrize::Scanline> rasterizePolyline(const T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> lines;
+
+    const geometrize::BoundingBox clip{xMin, yMin, xMax - 1, yMax - 1};
+    for(std::size_t i = 0; i < s.m_points.size(); i++) {
+        const std::pair<std::int32_t, std::int32_t> p0{s.m_points[i].first, s.m_points[i].second};
+        const std::pair<std::int32_t, std::int32_t> p1{i < (s.m_points.size() - 1) ? std::make_pair(static_cast<std::int32_t>(s.m_points[i + 1].first), static_cast<std::int32_t>(s.m_points[i + 1].second)) : p0};
+        appendLineSpans(p0.first, p0.second, p1.first, p1.second, clip, lines);
+    }
+
+    // Prevent scanline overlap, it messes up the energy functions that rely on the scanlines not intersecting themselves
+    mergeSpans(lines);
+
+    return lines;
+}
+
+}
+
+namespace geometrize
+{
+
+std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRectangle& r)
+{
+    return ::cornerPoints(r);
+}
+
+std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRectangleValue& r)
+{
+    return ::cornerPoints(r);
+}
+
+std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize::RotatedEllipse& e, const std::size_t numPoints)
+{
+    return ::pointsOnRotatedEllipse(e, numPoints);
+}
+
+std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize::RotatedEllipseValue& e, const std::size_t numPoints)
+{
+    return ::pointsOnRotatedEllipse(e, numPoints);
+}
+
+std::vector<std::pair<float, float>> getPointsOnQuadraticBezier(const geometrize::QuadraticBezier& s, const float tolerance)
+{
+    return ::pointsOnQuadraticBezier(s, tolerance);
+}
+
+std::vector<std::pair<float, float>> getPointsOnQuadraticBezier(const geometrize::QuadraticBezierValue& s, const float tolerance)
+{
+    return ::pointsOnQuadraticBezier(s, tolerance);
+}
+
+void drawLines(geometrize::Bitmap& image, const geometrize::rgba color, const std::vector<geometrize::Scanline>& lines)
+{
+    drawSpans(image, color, lines);
+}
+
+void drawLines(geometrize::Bitmap& image, const geometrize::rgba color, const geometrize::ScanlineSet& lines)
+{
+    drawSpans(image, color, lines);
+}
+
+void copyLines(geometrize::Bitmap& destination, const geometrize::Bitmap& source, const std::vector<geometrize::Scanline>& lines)
+{
+    copySpans(destination, source, lines);
+}
+
+void copyLines(geometrize::Bitmap& destination, const geometrize::Bitmap& source, const geometrize::ScanlineSet& lines)
+{
+    copySpans(destination, source, lines);
+}
+
+std::vector<std::pair<std::int32_t, std::int32_t>> bresenham(const std::int32_t x1, const std::int32_t y1, const std::int32_t x2, const std::int32_t y2)
+{
+    std::vector<std::pair<std::int32_t, std::int32_t>> points;
+    forEachLinePoint(x1, y1, x2, y2, [&points](const std::int32_t x, const std::int32_t y) {
+        points.push_back(std::make_pair(x, y));
+    });
+    return points;
+}
+
+std::vector<geometrize::Scanline> scanlinesForPolygon(const std::vector<std::pair<float, float>>& points)
+{
+    return scanlinesForPolygon(points, INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX);
+}
+
+std::vector<geometrize::Scanline> scanlinesForPolygon(const std::vector<std::pair<float, float>>& points, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<geometrize::Scanline> lines;
+    if(points.empty()) {
+        return lines;
+    }
+
+    const geometrize::BoundingBox clip{xMin, yMin, xMax - 1, yMax - 1};
+    const geometrize::BoundingBox bounds{clipBounds(::getBounds(points), xMin, yMin, xMax, yMax)};
+    if(isEmpty(bounds)) {
+        return lines;
+    }
+
+    // Walk the pixel outline of the polygon, tracking the leftmost and rightmost outline pixel on each visible row
+    std::vector<std::pair<std::int32_t, std::int32_t>> rowExtents(static_cast<std::size_t>(bounds.yMax - bounds.yMin) + 1U, std::make_pair(INT32_MAX, INT32_MIN));
+    for(std::size_t i = 0; i < points.size(); i++) {
+        const std::pair<float, float>& p1{points[i]};
+        const std::pair<float, float>& p2{(i == (points.size() - 1)) ? points[0U] : points[i + 1U]};
+        forEachLinePoint(static_cast<std::int32_t>(p1.first), static_cast<std::int32_t>(p1.second), static_cast<std::int32_t>(p2.first), static_cast<std::int32_t>(p2.second),
+                         [&rowExtents, &bounds](const std::int32_t x, const std::int32_t y) {
+            if(y < bounds.yMin || y > bounds.yMax) {
+                return;
+            }
+            std::pair<std::int32_t, std::int32_t>& extent{rowExtents[static_cast<std::size_t>(y - bounds.yMin)]};
+            extent.first = (std::min)(extent.first, x);
+            extent.second = (std::max)(extent.second, x);
+        });
+    }
+
+    // Convert outline to scanlines
+    lines.reserve(rowExtents.size());
+    for(std::size_t row = 0; row < rowExtents.size(); row++) {
+        const std::pair<std::int32_t, std::int32_t>& extent{rowExtents[row]};
+        if(extent.first <= extent.second) {
+            addClippedScanline(lines, bounds.yMin + static_cast<std::int32_t>(row), extent.first, extent.second, clip);
+        }
+    }
+
+    return lines;
+}
+
+geometrize::BoundingBox getBounds(const geometrize::Shape& s)
+{
+    switch(s.getType()) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        return getBounds(static_cast<const geometrize::Rectangle&>(s));
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        return getBounds(static_cast<const geometrize::RotatedRectangle&>(s));
+    case geometrize::ShapeTypes::TRIANGLE:
+        return getBounds(static_cast<const geometrize::Triangle&>(s));
+    case geometrize::ShapeTypes::ELLIPSE:
+        return getBounds(static_cast<const geometrize::Ellipse&>(s));
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        return getBounds(static_cast<const geometrize::RotatedEllipse&>(s));
+    case geometrize::ShapeTypes::CIRCLE:
+        return getBounds(static_cast<const geometrize::Circle&>(s));
+    case geometrize::ShapeTypes::LINE:
+        return getBounds(static_cast<const geometrize::Line&>(s));
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        return getBounds(static_cast<const geometrize::QuadraticBezier&>(s));
+    case geometrize::ShapeTypes::POLYLINE:
+        return getBounds(static_cast<const geometrize::Polyline&>(s));
+    default:
+        assert(0 && "Bad shape type");
+        return geometrize::BoundingBox{0, 0, -1, -1};
+    }
+}
+
+geometrize::BoundingBox getBounds(const geometrize::ShapeValue& s)
+{
+    switch(s.m_type) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        return ::boundsRectangle(s.m_rectangle);
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        return ::boundsRotatedRectangle(s.m_rotatedRectangle);
+    case geometrize::ShapeTypes::TRIANGLE:
+        return ::boundsTriangle(s.m_triangle);
+    case geometrize::ShapeTypes::ELLIPSE:
+        return ::boundsEllipse(s.m_ellipse);
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        return ::boundsRotatedEllipse(s.m_rotatedEllipse);
+    case geometrize::ShapeTypes::CIRCLE:
+        return ::boundsCircle(s.m_circle);
+    case geometrize::ShapeTypes::LINE:
+        return ::boundsLine(s.m_line);
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        return ::boundsQuadraticBezier(s.m_quadraticBezier);
+    case geometrize::ShapeTypes::POLYLINE:
+        return ::boundsPolyline(s.m_polyline);
+    default:
+        assert(0 && "Bad shape type");
+        return geometrize::BoundingBox{0, 0, -1, -1};
+    }
+}
+
+geometrize::BoundingBox getBounds(const geometrize::CircleValue& s)
 {
-    // Convert the non-premultiplied color to alpha-premultiplied 16-bits per channel RGBA
-    // In other words, scale the rgb color components by the alpha component
-    std::uint32_t sr{color.r};
-    sr |= sr << 8;
-    sr *= color.a;
-    sr /= UINT8_MAX;
-    std::uint32_t sg{color.g};
-    sg |= sg << 8;
-    sg *= color.a;
-    sg /= UINT8_MAX;
-    std::uint32_t sb{color.b};
-    sb |= sb << 8;
-    sb *= color.a;
-    sb /= UINT8_MAX;
-    std::uint32_t sa{color.a};
-    sa |= sa << 8;
-
-    const std::uint32_t m{UINT16_MAX};
-    const std::uint32_t aa{(m - sa) * 257U};
-
-    for(const geometrize::Scanline& line : lines) {
-        const std::int32_t y{line.y};
+    return ::boundsCircle(s);
+}
 
-        for(std::int32_t x = line.x1; x <= line.x2; x++) {
-            const geometrize::rgba d(image.getPixel(x, y));
+geometrize::BoundingBox getBounds(const geometrize::EllipseValue& s)
+{
+    return ::boundsEllipse(s);
+}
 
-            const std::uint8_t r{static_cast<std::uint8_t>(((d.r * aa + sr * m) / m) >> 8)};
-            const std::uint8_t g{static_cast<std::uint8_t>(((d.g * aa + sg * m) / m) >> 8)};
-            const std::uint8_t b{static_cast<std::uint8_t>(((d.b * aa + sb * m) / m) >> 8)};
-            const std::uint8_t a{static_cast<std::uint8_t>(((d.a * aa + sa * m) / m) >> 8)};
+geometrize::BoundingBox getBounds(const geometrize::LineValue& s)
+{
+    return ::boundsLine(s);
+}
 
-            image.setPixel(x, y, geometrize::rgba{r, g, b, a});
-        }
-    }
+geometrize::BoundingBox getBounds(const geometrize::PolylineValue& s)
+{
+    return ::boundsPolyline(s);
 }
 
-void copyLines(geometrize::Bitmap& destination, const geometrize::Bitmap& source, const std::vector<geometrize::Scanline>& lines)
+geometrize::BoundingBox getBounds(const geometrize::QuadraticBezierValue& s)
 {
-    for(const geometrize::Scanline& line : lines) {
-        const std::int32_t y{line.y};
-        for(std::int32_t x = line.x1; x <= line.x2; x++) {
-            destination.setPixel(x, y, source.getPixel(x, y));
-        }
-    }
+    return ::boundsQuadraticBezier(s);
 }
 
-std::vector<std::pair<std::int32_t, std::int32_t>> bresenham(std::int32_t x1, std::int32_t y1, const std::int32_t x2, const std::int32_t y2)
+geometrize::BoundingBox getBounds(const geometrize::RectangleValue& s)
 {
-    std::int32_t dx{x2 - x1};
-    const std::int8_t ix{static_cast<std::int8_t>((dx > 0) - (dx < 0))};
-    dx = std::abs(dx) << 1;
+    return ::boundsRectangle(s);
+}
 
-    std::int32_t dy{y2 - y1};
-    const std::int8_t iy{static_cast<std::int8_t>((dy > 0) - (dy < 0))};
-    dy = std::abs(dy) << 1;
+geometrize::BoundingBox getBounds(const geometrize::RotatedEllipseValue& s)
+{
+    return ::boundsRotatedEllipse(s);
+}
 
-    std::vector<std::pair<std::int32_t, std::int32_t>> points;
-    points.push_back(std::make_pair(x1, y1));
+geometrize::BoundingBox getBounds(const geometrize::RotatedRectangleValue& s)
+{
+    return ::boundsRotatedRectangle(s);
+}
 
-    if (dx >= dy) {
-        std::int32_t error(dy - (dx >> 1));
-        while (x1 != x2) {
-            if (error >= 0 && (error || (ix > 0))) {
-                error -= dx;
-                y1 += iy;
-            }
+geometrize::BoundingBox getBounds(const geometrize::TriangleValue& s)
+{
+    return ::boundsTriangle(s);
+}
 
-            error += dy;
-            x1 += ix;
+geometrize::BoundingBox getBounds(const geometrize::Circle& s)
+{
+    return ::boundsCircle(s);
+}
 
-            points.push_back(std::make_pair(x1, y1));
-        }
-    } else {
-        std::int32_t error(dx - (dy >> 1));
-        while (y1 != y2) {
-            if (error >= 0 && (error || (iy > 0))) {
-                error -= dy;
-                x1 += ix;
-            }
+geometrize::BoundingBox getBounds(const geometrize::Ellipse& s)
+{
+    return ::boundsEllipse(s);
+}
 
-            error += dx;
-            y1 += iy;
+geometrize::BoundingBox getBounds(const geometrize::Line& s)
+{
+    return ::boundsLine(s);
+}
 
-            points.push_back(std::make_pair(x1, y1));
-        }
-    }
+geometrize::BoundingBox getBounds(const geometrize::Polyline& s)
+{
+    return ::boundsPolyline(s);
+}
 
-    return points;
+geometrize::BoundingBox getBounds(const geometrize::QuadraticBezier& s)
+{
+    return ::boundsQuadraticBezier(s);
 }
 
-std::vector<geometrize::Scanline> scanlinesForPolygon(const std::vector<std::pair<float, float>>& points)
+geometrize::BoundingBox getBounds(const geometrize::Rectangle& s)
 {
-    std::vector<geometrize::Scanline> lines;
+    return ::boundsRectangle(s);
+}
 
-    // Get the pixel outline of the polygon
-    std::vector<std::pair<std::int32_t, std::int32_t>> edges;
-    for(std::size_t i = 0; i < points.size(); i++) {
-        const std::pair<std::int32_t, std::int32_t> p1{static_cast<std::int32_t>(points[i].first), static_cast<std::int32_t>(points[i].second)};
-        const std::pair<std::int32_t, std::int32_t> p2{(i == (points.size() - 1)) ? std::make_pair(static_cast<std::int32_t>(points[0U].first), static_cast<std::int32_t>(points[0U].second)) : std::make_pair(static_cast<std::int32_t>(points[i + 1U].first), static_cast<std::int32_t>(points[i + 1U].second))};
-        const std::vector<std::pair<std::int32_t, std::int32_t>> p1p2{geometrize::bresenham(p1.first, p1.second, p2.first, p2.second)};
-        edges.insert(edges.end(), p1p2.begin(), p1p2.end());
-    }
+geometrize::BoundingBox getBounds(const geometrize::RotatedEllipse& s)
+{
+    return ::boundsRotatedEllipse(s);
+}
 
-    // Convert outline to scanlines
-    std::map<std::int32_t, std::set<std::int32_t>> yToXs;
-    for(std::pair<std::int32_t, std::int32_t> point : edges) {
-        yToXs[point.second].insert(point.first);
-    }
-    for(const auto& it : yToXs) {
-        const geometrize::Scanline scanline(it.first,
-        *(std::min_element(it.second.begin(), it.second.end())),
-        *(std::max_element(it.second.begin(), it.second.end())));
-        lines.push_back(scanline);
-    }
+geometrize::BoundingBox getBounds(const geometrize::RotatedRectangle& s)
+{
+    return ::boundsRotatedRectangle(s);
+}
 
-    return lines;
+geometrize::BoundingBox getBounds(const geometrize::Triangle& s)
+{
+    return ::boundsTriangle(s);
 }
 
 std::vector<geometrize::Scanline> rasterize(const geometrize::Shape& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax)
@@ -218,179 +1016,201 @@ std::vector<geometrize::Scanline> rasterize(const geometrize::Shape& s, std::int
     }
 }
 
-std::vector<geometrize::Scanline> rasterize(const geometrize::Circle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+std::vector<geometrize::Scanline> rasterize(const geometrize::ShapeValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    std::vector<geometrize::Scanline> lines;
-
-    const std::int32_t r{static_cast<std::int32_t>(s.m_r)};
-    for(std::int32_t y = -r; y <= r; y++) {
-        std::vector<std::int32_t> xScan;
-        for(std::int32_t x = -r; x <= r; x++) {
-            if(x * x + y * y <= r * r) {
-                xScan.push_back(x);
-            }
-        }
-
-        if(!xScan.empty()) {
-            const std::int32_t fy{static_cast<std::int32_t>(s.m_y) + y};
-            const std::int32_t x1{commonutil::clamp(static_cast<std::int32_t>(s.m_x) + xScan.front(), xMin, xMax - 1)};
-            const std::int32_t x2{commonutil::clamp(static_cast<std::int32_t>(s.m_x) + xScan.back(), xMin, xMax - 1)};
-            lines.push_back(geometrize::Scanline(fy, x1, x2));
-        }
+    switch(s.m_type) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        return ::rasterizeRectangle(s.m_rectangle, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        return ::rasterizeRotatedRectangle(s.m_rotatedRectangle, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::TRIANGLE:
+        return ::rasterizeTriangle(s.m_triangle, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::ELLIPSE:
+        return ::rasterizeEllipse(s.m_ellipse, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        return ::rasterizeRotatedEllipse(s.m_rotatedEllipse, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::CIRCLE:
+        return ::rasterizeCircle(s.m_circle, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::LINE:
+        return ::rasterizeLine(s.m_line, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        return ::rasterizeQuadraticBezier(s.m_quadraticBezier, xMin, yMin, xMax, yMax);
+    case geometrize::ShapeTypes::POLYLINE:
+        return ::rasterizePolyline(s.m_polyline, xMin, yMin, xMax, yMax);
+    default:
+        assert(0 && "Bad shape type");
+        return {};
     }
+}
 
-    return geometrize::trimScanlines(lines, xMin, yMin, xMax, yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::CircleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeCircle(s, xMin, yMin, xMax, yMax);
 }
 
-std::vector<geometrize::Scanline> rasterize(const geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+std::vector<geometrize::Scanline> rasterize(const geometrize::EllipseValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    std::vector<geometrize::Scanline> lines;
+    return ::rasterizeEllipse(s, xMin, yMin, xMax, yMax);
+}
 
-    const float aspect{static_cast<float>(s.m_rx) / static_cast<float>(s.m_ry)};
+std::vector<geometrize::Scanline> rasterize(const geometrize::LineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeLine(s, xMin, yMin, xMax, yMax);
+}
 
-    for (std::int32_t dy = 0; dy < s.m_ry; dy++) {
-        const std::int32_t y1{static_cast<std::int32_t>(s.m_y) - dy};
-        const std::int32_t y2{static_cast<std::int32_t>(s.m_y) + dy};
+std::vector<geometrize::Scanline> rasterize(const geometrize::PolylineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizePolyline(s, xMin, yMin, xMax, yMax);
+}
 
-        if ((y1 < yMin || y1 >= yMax) && (y2 < yMin || y2 >= yMax)) {
-            continue;
-        }
+std::vector<geometrize::Scanline> rasterize(const geometrize::QuadraticBezierValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeQuadraticBezier(s, xMin, yMin, xMax, yMax);
+}
 
-        const std::int32_t v{static_cast<std::int32_t>(std::sqrt(s.m_ry * s.m_ry - dy * dy) * aspect)};
-        std::int32_t x1{static_cast<std::int32_t>(s.m_x) - v};
-        std::int32_t x2{static_cast<std::int32_t>(s.m_x) + v};
-        if (x1 < xMin) {
-            x1 = xMin;
-        }
-        if (x2 >= xMax) {
-            x2 = xMax - 1;
-        }
+std::vector<geometrize::Scanline> rasterize(const geometrize::RectangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeRectangle(s, xMin, yMin, xMax, yMax);
+}
 
-        if (y1 >= xMin && y1 < yMax) {
-            lines.push_back(Scanline(y1, x1, x2));
-        }
-        if (y2 >= yMin && y2 < yMax && dy > 0) {
-            lines.push_back(Scanline(y2, x1, x2));
-        }
-    }
+std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedEllipseValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeRotatedEllipse(s, xMin, yMin, xMax, yMax);
+}
 
-    return geometrize::trimScanlines(lines, xMin, yMin, xMax, yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedRectangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeRotatedRectangle(s, xMin, yMin, xMax, yMax);
 }
 
-std::vector<geometrize::Scanline> rasterize(const geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+std::vector<geometrize::Scanline> rasterize(const geometrize::TriangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    std::vector<geometrize::Scanline> lines;
+    return ::rasterizeTriangle(s, xMin, yMin, xMax, yMax);
+}
 
-    const std::vector<std::pair<std::int32_t, std::int32_t>> points{geometrize::bresenham(static_cast<std::int32_t>(s.m_x1), static_cast<std::int32_t>(s.m_y1), static_cast<std::int32_t>(s.m_x2), static_cast<std::int32_t>(s.m_y2))};
-    for(const auto& point : points) {
-       lines.push_back(geometrize::Scanline(point.second, point.first, point.first));
+void rasterize(const geometrize::CircleValue* const shapes, const std::size_t count, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax, geometrize::SpanBatch& batch)
+{
+    // The templates of the whole batch are fetched up front, the cache holds more than a batch of them so none is remade while they are in use
+    const std::int32_t* halfWidths[geometrize::SpanBatch::MAX_SHAPES]{};
+    for(std::size_t k = 0; k < count; k++) {
+        halfWidths[k] = circleHalfWidths(static_cast<std::int32_t>(shapes[k].m_r)).data();
     }
-
-    return geometrize::trimScanlines(lines, xMin, yMin, xMax, yMax);
+    ::rasterizeBatch(count, xMin, yMin, xMax, yMax, batch, [shapes](const std::size_t k, std::int32_t& first, std::int32_t& last) {
+        const geometrize::BoundingBox bounds{::boundsCircle(shapes[k])};
+        first = bounds.yMin;
+        last = bounds.yMax;
+    }, [shapes, &halfWidths](const std::size_t k, const std::int32_t y, std::int32_t& x1, std::int32_t& x2) {
+        const std::int32_t x{static_cast<std::int32_t>(shapes[k].m_x)};
+        const std::int32_t dx{halfWidths[k][std::abs(y - static_cast<std::int32_t>(shapes[k].m_y))]};
+        x1 = x - dx;
+        x2 = x + dx;
+    });
 }
 
-std::vector<geometrize::Scanline> rasterize(const geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+void rasterize(const geometrize::EllipseValue* const shapes, const std::size_t count, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax, geometrize::SpanBatch& batch)
 {
-    std::vector<geometrize::Scanline> lines;
-
-    // Prevent scanline overlap, it messes up the energy functions that rely on the scanlines not intersecting themselves
-    std::set<std::pair<std::int32_t, std::int32_t>> duplicates;
-
-    for(std::size_t i = 0; i < s.m_points.size(); i++) {
-        const std::pair<std::int32_t, std::int32_t> p0{s.m_points[i].first, s.m_points[i].second};
-        const std::pair<std::int32_t, std::int32_t> p1{i < (s.m_points.size() - 1) ? std::make_pair(static_cast<std::int32_t>(s.m_points[i + 1].first), static_cast<std::int32_t>(s.m_points[i + 1].second)) : p0};
-
-        const std::vector<std::pair<std::int32_t, std::int32_t>> points{geometrize::bresenham(p0.first, p0.second, p1.first, p1.second)};
-        for(const auto& point : points) {
-            if(duplicates.insert(point).second) {
-                lines.push_back(geometrize::Scanline(point.second, point.first, point.first));
-            }
-        }
+    const std::int32_t* halfWidths[geometrize::SpanBatch::MAX_SHAPES]{};
+    std::int32_t rowCounts[geometrize::SpanBatch::MAX_SHAPES]{};
+    for(std::size_t k = 0; k < count; k++) {
+        const std::vector<std::int32_t>& widths{ellipseHalfWidths(shapes[k])};
+        halfWidths[k] = widths.data();
+        rowCounts[k] = static_cast<std::int32_t>(widths.size());
     }
-
-    return geometrize::trimScanlines(lines, xMin, yMin, xMax, yMax);
+    ::rasterizeBatch(count, xMin, yMin, xMax, yMax, batch, [shapes, &rowCounts](const std::size_t k, std::int32_t& first, std::int32_t& last) {
+        const std::int32_t y{static_cast<std::int32_t>(shapes[k].m_y)};
+        first = y - rowCounts[k] + 1;
+        last = y + rowCounts[k] - 1;
+    }, [shapes, &halfWidths](const std::size_t k, const std::int32_t y, std::int32_t& x1, std::int32_t& x2) {
+        const std::int32_t x{static_cast<std::int32_t>(shapes[k].m_x)};
+        const std::int32_t v{halfWidths[k][std::abs(y - static_cast<std::int32_t>(shapes[k].m_y))]};
+        x1 = x - v;
+        x2 = x + v;
+    });
 }
 
-std::vector<geometrize::Scanline> rasterize(const geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+void rasterize(const geometrize::RectangleValue* const shapes, const std::size_t count, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax, geometrize::SpanBatch& batch)
 {
-    std::vector<geometrize::Scanline> scanlines;
-
-    std::vector<std::pair<std::int32_t, std::int32_t>> points;
-    const std::uint32_t pointCount{20};
-    for(std::uint32_t i = 0; i <= pointCount; i++) {
-        const float t{static_cast<float>(i) / static_cast<float>(pointCount)};
-        const float tp{1 - t};
-        const std::int32_t x{static_cast<std::int32_t>(tp * (tp * s.m_x1 + (t * s.m_cx)) + t * ((tp * s.m_cx) + (t * s.m_x2)))};
-        const std::int32_t y{static_cast<std::int32_t>(tp * (tp * s.m_y1 + (t * s.m_cy)) + t * ((tp * s.m_cy) + (t * s.m_y2)))};
-        points.push_back(std::make_pair(x, y));
+    geometrize::BoundingBox bounds[geometrize::SpanBatch::MAX_SHAPES]{};
+    for(std::size_t k = 0; k < count; k++) {
+        bounds[k] = ::boundsRectangle(shapes[k]);
     }
+    ::rasterizeBatch(count, xMin, yMin, xMax, yMax, batch, [&bounds](const std::size_t k, std::int32_t& first, std::int32_t& last) {
+        first = bounds[k].yMin;
+        last = bounds[k].yMax;
+    }, [&bounds](const std::size_t k, const std::int32_t, std::int32_t& x1, std::int32_t& x2) {
+        x1 = bounds[k].xMin;
+        x2 = bounds[k].xMax;
+    });
+}
 
-    // Prevent scanline overlap, it messes up the energy functions that rely on the scanlines not intersecting themselves
-    std::set<std::pair<std::int32_t, std::int32_t>> duplicates;
+std::vector<geometrize::Scanline> rasterize(const geometrize::Circle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeCircle(s, xMin, yMin, xMax, yMax);
+}
 
-    for(std::uint32_t i = 0; i < points.size() - 1; i++) {
-        const std::pair<std::int32_t, std::int32_t> p0{points[i]};
-        const std::pair<std::int32_t, std::int32_t> p1{points[i + 1]};
+std::vector<geometrize::Scanline> rasterize(const geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeEllipse(s, xMin, yMin, xMax, yMax);
+}
 
-        const std::vector<std::pair<std::int32_t, std::int32_t>> points{geometrize::bresenham(static_cast<std::int32_t>(p0.first), static_cast<std::int32_t>(p0.second), static_cast<std::int32_t>(p1.first), static_cast<std::int32_t>(p1.second))};
-        for(const std::pair<std::int32_t, std::int32_t>& point : points) {
-            if(duplicates.insert(point).second) {
-                scanlines.push_back(geometrize::Scanline(point.second, point.first, point.first));
-            }
-        }
-    }
+std::vector<geometrize::Scanline> rasterize(const geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeLine(s, xMin, yMin, xMax, yMax);
+}
 
-    return geometrize::trimScanlines(scanlines, xMin, yMin, xMax, yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizePolyline(s, xMin, yMin, xMax, yMax);
 }
 
-std::vector<geometrize::Scanline> rasterize(const geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+std::vector<geometrize::Scanline> rasterize(const geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    const std::int32_t x1{static_cast<std::int32_t>((std::fmin)(s.m_x1, s.m_x2))};
-    const std::int32_t x2{static_cast<std::int32_t>((std::fmax)(s.m_x1, s.m_x2))};
-    const std::int32_t y1{static_cast<std::int32_t>((std::fmin)(s.m_y1, s.m_y2))};
-    const std::int32_t y2{static_cast<std::int32_t>((std::fmax)(s.m_y1, s.m_y2))};
+    return ::rasterizeQuadraticBezier(s, xMin, yMin, xMax, yMax);
+}
 
-    std::vector<geometrize::Scanline> lines;
-    for(std::int32_t y = y1; y <= y2; y++) {
-        lines.push_back(geometrize::Scanline(y, x1, x2));
-    }
-    return geometrize::trimScanlines(lines, xMin, yMin, xMax, yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    return ::rasterizeRectangle(s, xMin, yMin, xMax, yMax);
 }
 
 std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    const std::uint32_t pointCount{20};
-    std::vector<std::pair<float, float>> points = getPointsOnRotatedEllipse(s, pointCount);
-
-    std::vector<geometrize::Scanline> scanlines{geometrize::scanlinesForPolygon(points)};
-    return geometrize::trimScanlines(scanlines, xMin, yMin, xMax, yMax);
+    return ::rasterizeRotatedEllipse(s, xMin, yMin, xMax, yMax);
 }
 
 std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedRectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    std::vector<geometrize::Scanline> scanlines{geometrize::scanlinesForPolygon(getCornerPoints(s))};
-    return geometrize::trimScanlines(scanlines, xMin, yMin, xMax, yMax);
+    return ::rasterizeRotatedRectangle(s, xMin, yMin, xMax, yMax);
 }
 
 std::vector<geometrize::Scanline> rasterize(const geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-     std::vector<geometrize::Scanline> scanlines = geometrize::scanlinesForPolygon({
-         {static_cast<std::int32_t>(s.m_x1), static_cast<std::int32_t>(s.m_y1)},
-         {static_cast<std::int32_t>(s.m_x2), static_cast<std::int32_t>(s.m_y2)},
-         {static_cast<std::int32_t>(s.m_x3), static_cast<std::int32_t>(s.m_y3)}});
-
-    return geometrize::trimScanlines(scanlines, xMin, yMin, xMax, yMax);
+    return ::rasterizeTriangle(s, xMin, yMin, xMax, yMax);
 }
 
 bool scanlinesOverlap(const std::vector<geometrize::Scanline>& first, const std::vector<geometrize::Scanline>& second)
 {
-    for(const auto& f : first) {
-        for(const auto& s : second) {
-            if(f.y == s.y) {
-                if(f.x1 <= s.x2 && f.x2 >= s.x1) {
-                    return true;
-                }
+    const std::vector<geometrize::Scanline> f{sortScanlines(first)};
+    const std::vector<geometrize::Scanline> s{sortScanlines(second)};
+
+    // Sweep both sets of scanlines in row order, on each row always advancing past the scanline that ends first
+    std::size_t i{0};
+    std::size_t j{0};
+    while(i < f.size() && j < s.size()) {
+        if(f[i].y != s[j].y) {
+            if(f[i].y < s[j].y) {
+                i++;
+            } else {
+                j++;
             }
+            continue;
+        }
+        if(f[i].x2 < s[j].x1) {
+            i++;
+        } else if(s[j].x2 < f[i].x1) {
+            j++;
+        } else {
+            return true;
         }
     }
     return false;
@@ -398,18 +1218,28 @@ bool scanlinesOverlap(const std::vector<geometrize::Scanline>& first, const std:
 
 bool scanlinesContain(const std::vector<geometrize::Scanline>& first, const std::vector<geometrize::Scanline>& second)
 {
-    for(const auto& s : second) {
-        bool contained = false;
-        for(const auto& f : first) {
-            if(f.y == s.y) {
-                if(f.x1 <= s.x1 && f.x2 >= s.x2) {
-                    contained = true;
-                    break;
-                }
+    const std::vector<geometrize::Scanline> f{sortScanlines(first)};
+    const std::vector<geometrize::Scanline> s{sortScanlines(second)};
+
+    // For each scanline in the second set, track the furthest extent of the scanlines in the first set that start at or before it on the same row
+    std::size_t i{0};
+    std::int32_t row{0};
+    std::int32_t furthestX2{0};
+    bool rowHasLines{false};
+    for(const geometrize::Scanline& line : s) {
+        if(!rowHasLines || line.y != row) {
+            row = line.y;
+            rowHasLines = false;
+            while(i < f.size() && f[i].y < row) {
+                i++;
             }
         }
-
-        if(!contained) {
+        while(i < f.size() && f[i].y == row && f[i].x1 <= line.x1) {
+            furthestX2 = rowHasLines ? (std::max)(furthestX2, f[i].x2) : f[i].x2;
+            rowHasLines = true;
+            i++;
+        }
+        if(!rowHasLines || furthestX2 < line.x2) {
             return false;
         }
     }
@@ -417,14 +1247,76 @@ bool scanlinesContain(const std::vector<geometrize::Scanline>& first, const std:
     return true;
 }
 
+bool scanlinesOverlap(const geometrize::ScanlineSet& first, const geometrize::ScanlineSet& second)
+{
+    return first.overlaps(second);
+}
+
+bool scanlinesContain(const geometrize::ScanlineSet& first, const geometrize::ScanlineSet& second)
+{
+    return first.contains(second);
+}
+
 bool shapesOverlap(const geometrize::Shape& a, const geometrize::Shape& b, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
+    if(!intersects(clipBounds(getBounds(a), xMin, yMin, xMax, yMax), clipBounds(getBounds(b), xMin, yMin, xMax, yMax))) {
+        return false;
+    }
     return geometrize::scanlinesOverlap(geometrize::rasterize(a, xMin, yMin, xMax, yMax), geometrize::rasterize(b, xMin, yMin, xMax, yMax));
 }
 
 bool shapeContains(const geometrize::Shape& container, const geometrize::Shape& containee, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
-    return geometrize::scanlinesContain(rasterize(container, xMin, yMin, xMax, yMax), rasterize(containee, xMin, yMin, xMax, yMax));
+    const std::vector<geometrize::Scanline> containeeLines{rasterize(containee, xMin, yMin, xMax, yMax)};
+    if(containeeLines.empty()) {
+        return true;
+    }
+    if(!contains(clipBounds(getBounds(container), xMin, yMin, xMax, yMax), ::getBounds(containeeLines))) {
+        return false;
+    }
+    return geometrize::scanlinesContain(rasterize(container, xMin, yMin, xMax, yMax), containeeLines);
+}
+
+std::vector<bool> shapesOverlap(const geometrize::Shape& shape, const std::vector<std::shared_ptr<geometrize::Shape>>& others, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<bool> results(others.size(), false);
+
+    const geometrize::ScanlineSet index{geometrize::rasterize(shape, xMin, yMin, xMax, yMax)};
+    if(index.empty()) {
+        return results;
+    }
+
+    for(std::size_t i = 0; i < others.size(); i++) {
+        const geometrize::Shape& other{*others[i]};
+        if(!intersects(index.getBounds(), clipBounds(getBounds(other), xMin, yMin, xMax, yMax))) {
+            continue;
+        }
+        const std::vector<geometrize::Scanline> lines{geometrize::rasterize(other, xMin, yMin, xMax, yMax)};
+        results[i] = std::any_of(lines.begin(), lines.end(), [&index](const geometrize::Scanline& line) { return index.overlaps(line); });
+    }
+
+    return results;
+}
+
+std::vector<bool> shapeContains(const geometrize::Shape& container, const std::vector<std::shared_ptr<geometrize::Shape>>& containees, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::vector<bool> results(containees.size(), false);
+
+    const geometrize::ScanlineSet index{geometrize::rasterize(container, xMin, yMin, xMax, yMax)};
+
+    for(std::size_t i = 0; i < containees.size(); i++) {
+        const std::vector<geometrize::Scanline> lines{geometrize::rasterize(*containees[i], xMin, yMin, xMax, yMax)};
+        if(lines.empty()) {
+            results[i] = true;
+            continue;
+        }
+        if(index.empty() || !contains(index.getBounds(), ::getBounds(lines))) {
+            continue;
+        }
+        results[i] = std::all_of(lines.begin(), lines.end(), [&index](const geometrize::Scanline& line) { return index.contains(line); });
+    }
+
+    return results;
 }
 
 std::vector<std::pair<std::int32_t, std::int32_t>> shapeToPixels(const geometrize::Shape& shape, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
@@ -439,4 +1331,140 @@ std::vector<std::pair<std::int32_t, std::int32_t>> shapeToPixels(const geometriz
     return points;
 }
 
+
+void EdgeSpanCache::rasterize(const geometrize::TriangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax, std::vector<geometrize::Scanline>& lines)
+{
+    m_vertices.clear();
+    m_vertices.push_back(std::make_pair(static_cast<std::int32_t>(s.m_x1), static_cast<std::int32_t>(s.m_y1)));
+    m_vertices.push_back(std::make_pair(static_cast<std::int32_t>(s.m_x2), static_cast<std::int32_t>(s.m_y2)));
+    m_vertices.push_back(std::make_pair(static_cast<std::int32_t>(s.m_x3), static_cast<std::int32_t>(s.m_y3)));
+    rasterizeVertices(true, xMin, yMin, xMax, yMax, lines);
+}
+
+void EdgeSpanCache::rasterize(const geometrize::PolylineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax, std::vector<geometrize::Scanline>& lines)
+{
+    m_vertices.clear();
+    for(const geometrize::PolylineValuePoint& point : s.m_points) {
+        m_vertices.push_back(std::make_pair(static_cast<std::int32_t>(point.first), static_cast<std::int32_t>(point.second)));
+    }
+    rasterizeVertices(false, xMin, yMin, xMax, yMax, lines);
+}
+
+void EdgeSpanCache::commit()
+{
+    for(std::size_t i = 0; i < m_edges.size(); i++) {
+        if(m_edgeChanged[i]) {
+            std::swap(m_baseEdges[i], m_edges[i]);
+        }
+    }
+    std::swap(m_baseVertices, m_vertices);
+    std::swap(m_baseLines, m_lines);
+    m_baseClosed = m_closed;
+    m_baseClip = m_clip;
+    m_hasBase = true;
+}
+
+void EdgeSpanCache::rasterizeVertices(const bool closed, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax, std::vector<geometrize::Scanline>& lines)
+{
+    const std::size_t edgeCount{m_vertices.size()};
+    m_closed = closed;
+    m_clip = geometrize::BoundingBox{xMin, yMin, xMax - 1, yMax - 1};
+
+    // Start from scratch unless the last committed shape has the same form and was rasterized in the same area
+    const bool rebuild{!m_hasBase || m_baseClosed != closed || m_baseVertices.size() != edgeCount
+                || m_baseClip.xMin != m_clip.xMin || m_baseClip.yMin != m_clip.yMin || m_baseClip.xMax != m_clip.xMax || m_baseClip.yMax != m_clip.yMax};
+    if(rebuild) {
+        m_hasBase = false;
+        m_baseLines.clear();
+        m_baseEdges.resize(edgeCount);
+        for(std::vector<geometrize::Scanline>& edge : m_baseEdges) {
+            edge.clear();
+        }
+    }
+    m_edges.resize(edgeCount);
+    m_edgeChanged.assign(edgeCount, rebuild);
+
+    // Each edge runs from one vertex to the next. Polylines end with a zero length segment at the last vertex, closed polygons with an edge back to the first vertex
+    const auto nextVertex = [edgeCount, closed](const std::size_t i) {
+        return i + 1U < edgeCount ? i + 1U : (closed ? 0U : i);
+    };
+    if(!rebuild) {
+        for(std::size_t i = 0; i < edgeCount; i++) {
+            const std::size_t j{nextVertex(i)};
+            m_edgeChanged[i] = m_vertices[i] != m_baseVertices[i] || m_vertices[j] != m_baseVertices[j];
+        }
+    }
+
+    // Walk the changed edges again, collecting the rows they covered before and cover now
+    std::int32_t rowMin{INT32_MAX};
+    std::int32_t rowMax{INT32_MIN};
+    const auto includeRows = [&rowMin, &rowMax](const std::vector<geometrize::Scanline>& edge) {
+        if(!edge.empty()) {
+            rowMin = (std::min)(rowMin, edge.front().y);
+            rowMax = (std::max)(rowMax, edge.back().y);
+        }
+    };
+    for(std::size_t i = 0; i < edgeCount; i++) {
+        if(!m_edgeChanged[i]) {
+            continue;
+        }
+        const std::pair<std::int32_t, std::int32_t>& p1{m_vertices[i]};
+        const std::pair<std::int32_t, std::int32_t>& p2{m_vertices[nextVertex(i)]};
+        walkEdgeRuns(p1.first, p1.second, p2.first, p2.second, m_clip.yMin, m_clip.yMax, m_edges[i]);
+        includeRows(m_baseEdges[i]);
+        includeRows(m_edges[i]);
+    }
+
+    // Rebuild the scanlines for the affected rows from the runs of all of the edges on them
+    m_rowLines.clear();
+    for(std::size_t i = 0; i < edgeCount && rowMin <= rowMax; i++) {
+        const std::vector<geometrize::Scanline>& edge{m_edgeChanged[i] ? m_edges[i] : m_baseEdges[i]};
+        if(edge.empty() || edge.back().y < rowMin || edge.front().y > rowMax) {
+            continue;
+        }
+        const std::size_t first{static_cast<std::size_t>((std::max)(rowMin, edge.front().y) - edge.front().y)};
+        const std::size_t last{static_cast<std::size_t>((std::min)(rowMax, edge.back().y) - edge.front().y)};
+        for(std::size_t r = first; r <= last; r++) {
+            const geometrize::Scanline& run{edge[r]};
+            if(!closed) {
+                addClippedScanline(m_rowLines, run.y, run.x1, run.x2, m_clip);
+                continue;
+            }
+            // Closed polygons fill each row between the leftmost and rightmost edge pixels, which are gathered here, one entry per row, and clipped below
+            if(m_rowLines.empty()) {
+                m_rowLines.assign(static_cast<std::size_t>(rowMax - rowMin) + 1U, geometrize::Scanline(0, INT32_MAX, INT32_MIN));
+            }
+            geometrize::Scanline& extent{m_rowLines[static_cast<std::size_t>(run.y - rowMin)]};
+            extent.x1 = (std::min)(extent.x1, run.x1);
+            extent.x2 = (std::max)(extent.x2, run.x2);
+        }
+    }
+    if(closed) {
+        std::size_t count{0};
+        for(std::size_t r = 0; r < m_rowLines.size(); r++) {
+            const geometrize::Scanline extent{m_rowLines[r]};
+            const std::int32_t y{rowMin + static_cast<std::int32_t>(r)};
+            if(extent.x1 <= extent.x2 && extent.x2 >= m_clip.xMin && extent.x1 <= m_clip.xMax) {
+                m_rowLines[count++] = geometrize::Scanline(y, (std::max)(extent.x1, m_clip.xMin), (std::min)(extent.x2, m_clip.xMax));
+            }
+        }
+        m_rowLines.resize(count);
+    } else {
+        mergeSpans(m_rowLines);
+    }
+
+    // Splice the rebuilt rows into the scanlines of the committed shape, which are sorted by row
+    const auto rowLess = [](const geometrize::Scanline& line, const std::int32_t y) {
+        return line.y < y;
+    };
+    const auto firstAffected = std::lower_bound(m_baseLines.begin(), m_baseLines.end(), rowMin, rowLess);
+    const auto lastAffected = rowMin <= rowMax ? std::lower_bound(firstAffected, m_baseLines.end(), rowMax + 1, rowLess) : firstAffected;
+    m_lines.clear();
+    m_lines.insert(m_lines.end(), m_baseLines.begin(), firstAffected);
+    m_lines.insert(m_lines.end(), m_rowLines.begin(), m_rowLines.end());
+    m_lines.insert(m_lines.end(), lastAffected, m_baseLines.end());
+
+    lines = m_lines;
+}
+
 }
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "../bitmap/rgba.h"
+#include "boundingbox.h"
+#include "scanline.h"
 
 namespace geometrize
 {
@@ -20,17 +24,36 @@ class RotatedEllipse;
 class RotatedRectangle;
 class Triangle;
 class Scanline;
+class ScanlineSet;
+struct SpanBatch;
+struct CircleValue;
+struct EllipseValue;
+struct LineValue;
+struct PolylineValue;
+struct QuadraticBezierValue;
+struct RectangleValue;
+struct RotatedEllipseValue;
+struct RotatedRectangleValue;
+struct TriangleValue;
+struct ShapeValue;
 }
 
 namespace geometrize
 {
 
+/**
+ * @brief QUADRATIC_BEZIER_FLATNESS_TOLERANCE The maximum distance (in pixels) allowed between a quadratic bezier curve and the line segments it is flattened into.
+ * Shared by the rasterizer and the SVG exporter so that rasterized and exported curves agree.
+ */
+static const float QUADRATIC_BEZIER_FLATNESS_TOLERANCE = 0.5f;
+
 /**
  * @brief getCornerPoints Gets the corner points of the given rotated rectangle.
  * @param r The rotated rectangle.
  * @return The corner points of the rotated rectangle.
  */
 std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRectangle& r);
+std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRectangleValue& r);
 
 /**
  * @brief getPointsOnRotatedEllipse Calculates and returns a number of points on the given rotated ellipse.
@@ -38,6 +61,16 @@ std::vector<std::pair<float, float>> getCornerPoints(const geometrize::RotatedRe
  * @return A vector containing the points on the rotated ellipse.
  */
 std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize::RotatedEllipse& e, std::size_t numPoints);
+std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize::RotatedEllipseValue& e, std::size_t numPoints);
+
+/**
+ * @brief getPointsOnQuadraticBezier Flattens the given quadratic bezier curve into a polyline. The number of points adapts to the curvature of the control polygon.
+ * @param s The quadratic bezier curve.
+ * @param tolerance The maximum distance between the curve and the polyline.
+ * @return A vector containing the points of the polyline, including both end points of the curve.
+ */
+std::vector<std::pair<float, float>> getPointsOnQuadraticBezier(const geometrize::QuadraticBezier& s, float tolerance = QUADRATIC_BEZIER_FLATNESS_TOLERANCE);
+std::vector<std::pair<float, float>> getPointsOnQuadraticBezier(const geometrize::QuadraticBezierValue& s, float tolerance = QUADRATIC_BEZIER_FLATNESS_TOLERANCE);
 
 /**
  * @brief drawLines Draws scanlines onto an image.
@@ -47,6 +80,14 @@ std::vector<std::pair<float, float>> getPointsOnRotatedEllipse(const geometrize:
  */
 void drawLines(geometrize::Bitmap& image, geometrize::rgba color, const std::vector<geometrize::Scanline>& lines);
 
+/**
+ * @brief drawLines Draws a set of scanlines onto an image, in row order.
+ * @param image The image to be drawn to.
+ * @param color The color of the scanlines.
+ * @param lines The scanlines to draw.
+ */
+void drawLines(geometrize::Bitmap& image, geometrize::rgba color, const geometrize::ScanlineSet& lines);
+
 /**
  * @brief copyLines Copies source pixels to a destination defined by a set of scanlines.
  * @param destination The destination bitmap to copy the lines to.
@@ -55,6 +96,14 @@ void drawLines(geometrize::Bitmap& image, geometrize::rgba color, const std::vec
  */
 void copyLines(geometrize::Bitmap& destination, const geometrize::Bitmap& source, const std::vector<geometrize::Scanline>& lines);
 
+/**
+ * @brief copyLines Copies source pixels to a destination defined by a set of scanlines, in row order.
+ * @param destination The destination bitmap to copy the lines to.
+ * @param source The source bitmap to copy the lines from.
+ * @param lines The scanlines that comprise the source to destination copying mask.
+ */
+void copyLines(geometrize::Bitmap& destination, const geometrize::Bitmap& source, const geometrize::ScanlineSet& lines);
+
 /**
  * @brief bresenham Bresenham's line algorithm. Returns the points on the line.
  * @param x1 The start x-coordinate.
@@ -72,6 +121,51 @@ std::vector<std::pair<std::int32_t, std::int32_t>> bresenham(std::int32_t x1, st
  */
 std::vector<geometrize::Scanline> scanlinesForPolygon(const std::vector<std::pair<float, float>>& points);
 
+/**
+ * @brief scanlinesForPolygon Gets the scanlines for a series of points that make up an arbitrary polygon, clipped to the given area.
+ * Only the rows within the area are ever visited.
+ * @param points The vertices of the polygon.
+ * @param xMin The minimum x value to clip to.
+ * @param yMin The minimum y value to clip to.
+ * @param xMax The maximum x value to clip to (exclusive).
+ * @param yMax The maximum y value to clip to (exclusive).
+ * @return Scanlines for the polygon.
+ */
+std::vector<geometrize::Scanline> scanlinesForPolygon(const std::vector<std::pair<float, float>>& points, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
+/**
+ * @brief getBounds Gets a conservative axis-aligned bounding box for the given shape, computed from the shape parameters alone (without rasterizing it).
+ * The scanlines produced by rasterizing the shape (before clipping) are guaranteed to lie within this box.
+ * @param s The shape.
+ * @return The bounding box of the shape.
+ */
+geometrize::BoundingBox getBounds(const geometrize::Shape& s);
+geometrize::BoundingBox getBounds(const geometrize::Circle& s);
+geometrize::BoundingBox getBounds(const geometrize::Ellipse& s);
+geometrize::BoundingBox getBounds(const geometrize::Line& s);
+geometrize::BoundingBox getBounds(const geometrize::Polyline& s);
+geometrize::BoundingBox getBounds(const geometrize::QuadraticBezier& s);
+geometrize::BoundingBox getBounds(const geometrize::Rectangle& s);
+geometrize::BoundingBox getBounds(const geometrize::RotatedEllipse& s);
+geometrize::BoundingBox getBounds(const geometrize::RotatedRectangle& s);
+geometrize::BoundingBox getBounds(const geometrize::Triangle& s);
+
+/**
+ * @brief getBounds Gets a conservative axis-aligned bounding box for the given shape value, the same box as for the equivalent shape.
+ * @param s The shape value.
+ * @return The bounding box of the shape value.
+ */
+geometrize::BoundingBox getBounds(const geometrize::ShapeValue& s);
+geometrize::BoundingBox getBounds(const geometrize::CircleValue& s);
+geometrize::BoundingBox getBounds(const geometrize::EllipseValue& s);
+geometrize::BoundingBox getBounds(const geometrize::LineValue& s);
+geometrize::BoundingBox getBounds(const geometrize::PolylineValue& s);
+geometrize::BoundingBox getBounds(const geometrize::QuadraticBezierValue& s);
+geometrize::BoundingBox getBounds(const geometrize::RectangleValue& s);
+geometrize::BoundingBox getBounds(const geometrize::RotatedEllipseValue& s);
+geometrize::BoundingBox getBounds(const geometrize::RotatedRectangleValue& s);
+geometrize::BoundingBox getBounds(const geometrize::TriangleValue& s);
+
 std::vector<geometrize::Scanline> rasterize(const geometrize::Shape& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 std::vector<geometrize::Scanline> rasterize(const geometrize::Circle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 std::vector<geometrize::Scanline> rasterize(const geometrize::Ellipse& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
@@ -83,6 +177,40 @@ std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedEllipse& s,
 std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedRectangle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 std::vector<geometrize::Scanline> rasterize(const geometrize::Triangle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 
+/**
+ * @brief rasterize Rasterizes the given shape value, producing the same scanlines as for the equivalent shape.
+ * @param s The shape value.
+ * @param xMin The minimum x value to clip to.
+ * @param yMin The minimum y value to clip to.
+ * @param xMax The maximum x value to clip to (exclusive).
+ * @param yMax The maximum y value to clip to (exclusive).
+ * @return The scanlines for the shape value.
+ */
+std::vector<geometrize::Scanline> rasterize(const geometrize::ShapeValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::CircleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::EllipseValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::LineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::PolylineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::QuadraticBezierValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::RectangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedEllipseValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::RotatedRectangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+std::vector<geometrize::Scanline> rasterize(const geometrize::TriangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
+/**
+ * @brief rasterize Rasterizes a batch of shape values together, a row at a time for all of the shapes, giving each shape the same spans as rasterizing it alone.
+ * @param shapes The shape values.
+ * @param count The number of shape values, at most SpanBatch::MAX_SHAPES.
+ * @param xMin The minimum x value to clip to.
+ * @param yMin The minimum y value to clip to.
+ * @param xMax The maximum x value to clip to (exclusive).
+ * @param yMax The maximum y value to clip to (exclusive).
+ * @param batch Receives the spans of the shape values.
+ */
+void rasterize(const geometrize::CircleValue* shapes, std::size_t count, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax, geometrize::SpanBatch& batch);
+void rasterize(const geometrize::EllipseValue* shapes, std::size_t count, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax, geometrize::SpanBatch& batch);
+void rasterize(const geometrize::RectangleValue* shapes, std::size_t count, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax, geometrize::SpanBatch& batch);
+
 /**
  * @brief scanlinesOverlap Returns true if any of the scanlines from the first vector overlap the second
  * @param first First collection of scanlines.
@@ -99,9 +227,123 @@ bool scanlinesOverlap(const std::vector<geometrize::Scanline>& first, const std:
  */
 bool scanlinesContain(const std::vector<geometrize::Scanline>& first, const std::vector<geometrize::Scanline>& second);
 
+/**
+ * @brief scanlinesOverlap Returns true if any of the scanlines from the first set overlap the second. Only the rows the sets share are visited.
+ * @param first First set of scanlines.
+ * @param second Second set of scanlines.
+ * @return True if there are any overlaps, else false.
+ */
+bool scanlinesOverlap(const geometrize::ScanlineSet& first, const geometrize::ScanlineSet& second);
+
+/**
+ * @brief scanlinesContain Returns true if the first set of scanlines wholly contains the second set. Only the rows of the second set are visited.
+ * @param first First set of scanlines.
+ * @param second Second set of scanlines.
+ * @return True if the first set of scanlines wholly contains the second set, else false.
+ */
+bool scanlinesContain(const geometrize::ScanlineSet& first, const geometrize::ScanlineSet& second);
+
+/**
+ * @brief shapesOverlap Returns true if the two shapes overlap once rasterized within the given area.
+ * Shapes whose bounding boxes do not intersect are rejected without being rasterized.
+ * @param a The first shape.
+ * @param b The second shape.
+ * @param xMin The minimum x value to rasterize within.
+ * @param yMin The minimum y value to rasterize within.
+ * @param xMax The maximum x value to rasterize within.
+ * @param yMax The maximum y value to rasterize within.
+ * @return True if the shapes overlap, else false.
+ */
 bool shapesOverlap(const geometrize::Shape& a, const geometrize::Shape& b, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
+/**
+ * @brief shapeContains Returns true if the container shape wholly contains the containee shape once both are rasterized within the given area.
+ * @param container The containing shape.
+ * @param containee The contained shape.
+ * @param xMin The minimum x value to rasterize within.
+ * @param yMin The minimum y value to rasterize within.
+ * @param xMax The maximum x value to rasterize within.
+ * @param yMax The maximum y value to rasterize within.
+ * @return True if the container wholly contains the containee, else false.
+ */
 bool shapeContains(const geometrize::Shape& container, const geometrize::Shape& containee, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 
+/**
+ * @brief shapesOverlap Tests one shape for overlap against many others. The shape is rasterized once into a scanline set that every other shape is tested against.
+ * @param shape The shape to test the others against.
+ * @param others The shapes to test.
+ * @param xMin The minimum x value to rasterize within.
+ * @param yMin The minimum y value to rasterize within.
+ * @param xMax The maximum x value to rasterize within.
+ * @param yMax The maximum y value to rasterize within.
+ * @return A vector the same size as others, each element is true if the corresponding shape overlaps the first shape, else false.
+ */
+std::vector<bool> shapesOverlap(const geometrize::Shape& shape, const std::vector<std::shared_ptr<geometrize::Shape>>& others, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
+/**
+ * @brief shapeContains Tests whether one shape wholly contains each of many others. The container is rasterized once into a scanline set that every other shape is tested against.
+ * @param container The containing shape.
+ * @param containees The shapes to test for containment.
+ * @param xMin The minimum x value to rasterize within.
+ * @param yMin The minimum y value to rasterize within.
+ * @param xMax The maximum x value to rasterize within.
+ * @param yMax The maximum y value to rasterize within.
+ * @return A vector the same size as containees, each element is true if the corresponding shape is wholly contained by the container, else false.
+ */
+std::vector<bool> shapeContains(const geometrize::Shape& container, const std::vector<std::shared_ptr<geometrize::Shape>>& containees, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
 std::vector<std::pair<std::int32_t, std::int32_t>> shapeToPixels(const geometrize::Shape& shape, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 
+
+/**
+ * @brief The EdgeSpanCache class rasterizes triangles and polylines incrementally, for optimizers that move one vertex at a time.
+ * The pixels covered by each edge of a triangle, or each segment of a polyline, are cached per row. When the next shape differs from the last committed one
+ * in only some of its vertices, only the edges touching those vertices are walked again, and the scanlines are only rebuilt for the rows those edges covered
+ * before or cover after. The scanlines produced are identical to those of the equivalent rasterize call.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class EdgeSpanCache
+{
+public:
+    EdgeSpanCache() = default;
+    ~EdgeSpanCache() = default;
+    EdgeSpanCache& operator=(const EdgeSpanCache&) = delete;
+    EdgeSpanCache(const EdgeSpanCache&) = delete;
+
+    /**
+     * @brief rasterize Rasterizes the given shape, reusing the edges of the last committed shape where the vertices at both ends of an edge are unchanged.
+     * @param s The shape to rasterize.
+     * @param xMin The minimum x value to rasterize within.
+     * @param yMin The minimum y value to rasterize within.
+     * @param xMax The maximum x value to rasterize within (exclusive).
+     * @param yMax The maximum y value to rasterize within (exclusive).
+     * @param lines Receives the scanlines of the shape.
+     */
+    void rasterize(const geometrize::TriangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax, std::vector<geometrize::Scanline>& lines);
+    void rasterize(const geometrize::PolylineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax, std::vector<geometrize::Scanline>& lines);
+
+    /**
+     * @brief commit Makes the shape passed to the last rasterize call the one that the next shapes are compared against.
+     */
+    void commit();
+
+private:
+    void rasterizeVertices(bool closed, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax, std::vector<geometrize::Scanline>& lines);
+
+    bool m_hasBase{false}; ///< Whether a shape has been committed.
+    bool m_baseClosed{false}; ///< Whether the committed shape is a closed polygon (a triangle) rather than a polyline.
+    geometrize::BoundingBox m_baseClip{0, 0, 0, 0}; ///< The area the committed shape was rasterized within, with inclusive maximum values.
+    std::vector<std::pair<std::int32_t, std::int32_t>> m_baseVertices; ///< The vertices of the committed shape.
+    std::vector<std::vector<geometrize::Scanline>> m_baseEdges; ///< The pixels of each edge of the committed shape, one unclipped run per row in ascending row order.
+    std::vector<geometrize::Scanline> m_baseLines; ///< The scanlines of the committed shape.
+
+    bool m_closed{false}; ///< Whether the last shape rasterized is a closed polygon.
+    geometrize::BoundingBox m_clip{0, 0, 0, 0}; ///< The area the last shape was rasterized within.
+    std::vector<std::pair<std::int32_t, std::int32_t>> m_vertices; ///< The vertices of the last shape rasterized.
+    std::vector<std::vector<geometrize::Scanline>> m_edges; ///< The pixels of the edges of the last shape rasterized, only valid for the changed edges.
+    std::vector<bool> m_edgeChanged; ///< Whether each edge of the last shape rasterized differs from the committed shape.
+    std::vector<geometrize::Scanline> m_lines; ///< The scanlines of the last shape rasterized.
+    std::vector<geometrize::Scanline> m_rowLines; ///< Scratch space for the scanlines of the rows being rebuilt.
+};
+
 }
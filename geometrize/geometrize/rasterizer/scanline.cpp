@@ -20,19 +20,20 @@ bool operator!=(const geometrize::Scanline& lhs, const geometrize::Scanline& rhs
     return lhs.y != rhs.y || lhs.x1 != rhs.x1 || lhs.x2 != rhs.x2;
 }
 
-std::vector<geometrize::Scanline> trimScanlines(const std::vector<geometrize::Scanline>& scanlines, std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY)
+std::vector<geometrize::Scanline> trimScanlines(const std::vector<geometrize::Scanline>& scanlines, const std::int32_t minX, const std::int32_t minY, const std::int32_t maxX, const std::int32_t maxY)
 {
     std::vector<geometrize::Scanline> trimmedScanlines;
+    trimmedScanlines.reserve(scanlines.size());
 
     for(const geometrize::Scanline& line : scanlines) {
         if(line.y < minY || line.y >= maxY) {
             continue;
         }
-        if(line.x1 > line.x2) {
+        if(line.x1 > line.x2 || line.x2 < minX || line.x1 >= maxX) {
             continue;
         }
-        const float x1 = geometrize::commonutil::clamp(line.x1, minX, maxX - 1);
-        const float x2 = geometrize::commonutil::clamp(line.x2, minX, maxX - 1);
+        const std::int32_t x1{geometrize::commonutil::clamp(line.x1, minX, maxX - 1)};
+        const std::int32_t x2{geometrize::commonutil::clamp(line.x2, minX, maxX - 1)};
         trimmedScanlines.emplace_back(Scanline(line.y, x1, x2));
     }
     return trimmedScanlines;
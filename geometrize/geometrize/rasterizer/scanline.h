@@ -39,7 +39,7 @@ bool operator==(const geometrize::Scanline& lhs, const geometrize::Scanline& rhs
 bool operator!=(const geometrize::Scanline& lhs, const geometrize::Scanline& rhs);
 
 /**
- * @brief trimScanlines Crops the scanning width of an array of scanlines so they do not scan outside of the given area.
+ * @brief trimScanlines Crops the scanning width of an array of scanlines so they do not scan outside of the given area. Scanlines lying wholly outside the area are removed.
  * @param scanlines The scanlines to crop.
  * @param minX The minimum x value to crop to.
  * @param minY The minimum y value to crop to.
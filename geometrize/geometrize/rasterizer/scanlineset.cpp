@@ -0,0 +1,240 @@
+#include "scanlineset.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "boundingbox.h"
+#include "scanline.h"
+
+namespace geometrize
+{
+
+ScanlineSet::ScanlineSet() : m_bounds{0, 0, -1, -1}, m_pixelCount{0}, m_compact{true}
+{
+}
+
+ScanlineSet::ScanlineSet(const std::vector<geometrize::Scanline>& lines) : ScanlineSet()
+{
+    std::vector<geometrize::Scanline> sorted;
+    sorted.reserve(lines.size());
+    std::copy_if(lines.begin(), lines.end(), std::back_inserter(sorted), [](const geometrize::Scanline& line) {
+        return line.x1 <= line.x2;
+    });
+    if(sorted.empty()) {
+        return;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const geometrize::Scanline& a, const geometrize::Scanline& b) {
+        return a.y < b.y || (a.y == b.y && a.x1 < b.x1);
+    });
+
+    // Merge overlapping and touching scanlines on each row
+    std::vector<geometrize::Scanline> merged;
+    merged.reserve(sorted.size());
+    for(const geometrize::Scanline& line : sorted) {
+        if(!merged.empty() && merged.back().y == line.y && line.x1 <= merged.back().x2 + 1) {
+            merged.back().x2 = (std::max)(merged.back().x2, line.x2);
+        } else {
+            merged.push_back(line);
+        }
+    }
+
+    m_bounds = geometrize::BoundingBox{merged.front().x1, merged.front().y, merged.front().x2, merged.back().y};
+    for(const geometrize::Scanline& line : merged) {
+        m_bounds.xMin = (std::min)(m_bounds.xMin, line.x1);
+        m_bounds.xMax = (std::max)(m_bounds.xMax, line.x2);
+        m_pixelCount += static_cast<std::uint64_t>(static_cast<std::int64_t>(line.x2) - line.x1 + 1);
+    }
+    m_compact = m_bounds.xMin >= INT16_MIN && m_bounds.xMax <= INT16_MAX;
+
+    m_rowOffsets.assign(static_cast<std::size_t>(m_bounds.yMax - m_bounds.yMin) + 2U, 0U);
+    for(const geometrize::Scanline& line : merged) {
+        m_rowOffsets[static_cast<std::size_t>(line.y - m_bounds.yMin) + 1U]++;
+    }
+    for(std::size_t row = 1; row < m_rowOffsets.size(); row++) {
+        m_rowOffsets[row] += m_rowOffsets[row - 1];
+    }
+
+    if(m_compact) {
+        m_compactX.reserve(merged.size() * 2U);
+        for(const geometrize::Scanline& line : merged) {
+            m_compactX.push_back(static_cast<std::int16_t>(line.x1));
+            m_compactX.push_back(static_cast<std::int16_t>(line.x2));
+        }
+    } else {
+        m_x.reserve(merged.size() * 2U);
+        for(const geometrize::Scanline& line : merged) {
+            m_x.push_back(line.x1);
+            m_x.push_back(line.x2);
+        }
+    }
+}
+
+bool ScanlineSet::empty() const
+{
+    return m_pixelCount == 0;
+}
+
+std::size_t ScanlineSet::getSpanCount() const
+{
+    return m_rowOffsets.empty() ? 0U : m_rowOffsets.back();
+}
+
+std::uint64_t ScanlineSet::getPixelCount() const
+{
+    return m_pixelCount;
+}
+
+const geometrize::BoundingBox& ScanlineSet::getBounds() const
+{
+    return m_bounds;
+}
+
+bool ScanlineSet::isCompact() const
+{
+    return m_compact;
+}
+
+bool ScanlineSet::overlaps(const geometrize::Scanline& line) const
+{
+    std::uint32_t begin{0};
+    std::uint32_t end{0};
+    if(line.x1 > line.x2 || !findRow(line.y, begin, end)) {
+        return false;
+    }
+
+    // Spans on a row are disjoint and sorted, so find the first one that ends at or after the start of the line
+    const std::uint32_t rowEnd{end};
+    while(begin < end) {
+        const std::uint32_t mid{begin + (end - begin) / 2U};
+        if(getX2(mid) < line.x1) {
+            begin = mid + 1U;
+        } else {
+            end = mid;
+        }
+    }
+    return begin < rowEnd && getX1(begin) <= line.x2;
+}
+
+bool ScanlineSet::contains(const geometrize::Scanline& line) const
+{
+    if(line.x1 > line.x2) {
+        return true;
+    }
+    std::uint32_t begin{0};
+    std::uint32_t end{0};
+    if(!findRow(line.y, begin, end)) {
+        return false;
+    }
+
+    // Touching spans are merged, so a contained line must lie within a single span
+    const std::uint32_t rowEnd{end};
+    while(begin < end) {
+        const std::uint32_t mid{begin + (end - begin) / 2U};
+        if(getX2(mid) < line.x1) {
+            begin = mid + 1U;
+        } else {
+            end = mid;
+        }
+    }
+    return begin < rowEnd && getX1(begin) <= line.x1 && getX2(begin) >= line.x2;
+}
+
+bool ScanlineSet::overlaps(const geometrize::ScanlineSet& other) const
+{
+    if(empty() || other.empty()) {
+        return false;
+    }
+    const std::int32_t yMin{(std::max)(m_bounds.yMin, other.m_bounds.yMin)};
+    const std::int32_t yMax{(std::min)(m_bounds.yMax, other.m_bounds.yMax)};
+    if(yMin > yMax || m_bounds.xMax < other.m_bounds.xMin || other.m_bounds.xMax < m_bounds.xMin) {
+        return false;
+    }
+
+    for(std::int32_t y = yMin; y <= yMax; y++) {
+        std::uint32_t i{0};
+        std::uint32_t iEnd{0};
+        std::uint32_t j{0};
+        std::uint32_t jEnd{0};
+        findRow(y, i, iEnd);
+        other.findRow(y, j, jEnd);
+        while(i < iEnd && j < jEnd) {
+            if(getX2(i) < other.getX1(j)) {
+                i++;
+            } else if(other.getX2(j) < getX1(i)) {
+                j++;
+            } else {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ScanlineSet::contains(const geometrize::ScanlineSet& other) const
+{
+    if(other.empty()) {
+        return true;
+    }
+    if(empty()) {
+        return false;
+    }
+    const geometrize::BoundingBox& b{other.m_bounds};
+    if(b.xMin < m_bounds.xMin || b.yMin < m_bounds.yMin || b.xMax > m_bounds.xMax || b.yMax > m_bounds.yMax) {
+        return false;
+    }
+
+    for(std::int32_t y = b.yMin; y <= b.yMax; y++) {
+        std::uint32_t i{0};
+        std::uint32_t iEnd{0};
+        std::uint32_t j{0};
+        std::uint32_t jEnd{0};
+        findRow(y, i, iEnd);
+        other.findRow(y, j, jEnd);
+        for(; j < jEnd; j++) {
+            while(i < iEnd && getX2(i) < other.getX1(j)) {
+                i++;
+            }
+            if(i == iEnd || getX1(i) > other.getX1(j) || getX2(i) < other.getX2(j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<geometrize::Scanline> ScanlineSet::toScanlines() const
+{
+    std::vector<geometrize::Scanline> lines;
+    lines.reserve(getSpanCount());
+    forEachSpan([&lines](const std::int32_t y, const std::int32_t x1, const std::int32_t x2) {
+        lines.push_back(geometrize::Scanline(y, x1, x2));
+    });
+    return lines;
+}
+
+std::int32_t ScanlineSet::getX1(const std::uint32_t span) const
+{
+    return m_compact ? m_compactX[span * 2U] : m_x[span * 2U];
+}
+
+std::int32_t ScanlineSet::getX2(const std::uint32_t span) const
+{
+    return m_compact ? m_compactX[span * 2U + 1U] : m_x[span * 2U + 1U];
+}
+
+bool ScanlineSet::findRow(const std::int32_t y, std::uint32_t& begin, std::uint32_t& end) const
+{
+    if(empty() || y < m_bounds.yMin || y > m_bounds.yMax) {
+        begin = end = 0;
+        return false;
+    }
+    const std::size_t row{static_cast<std::size_t>(y - m_bounds.yMin)};
+    begin = m_rowOffsets[row];
+    end = m_rowOffsets[row + 1U];
+    return begin < end;
+}
+
+}
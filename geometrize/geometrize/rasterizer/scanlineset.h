@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "boundingbox.h"
+#include "scanline.h"
+
+namespace geometrize
+{
+
+/**
+ * @brief The ScanlineSet class is a compact, row-indexed set of scanlines.
+ * Scanlines are stored sorted by row and then by x-coordinate, with overlapping and touching scanlines on a row merged, so every pixel is covered at most once.
+ * Rows are indexed by offset (compressed sparse row style), and x-coordinates are stored as 16-bit values when the bounds allow it.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class ScanlineSet
+{
+public:
+    /**
+     * @brief ScanlineSet Creates a new, empty scanline set.
+     */
+    ScanlineSet();
+
+    /**
+     * @brief ScanlineSet Creates a new scanline set from the given scanlines. The scanlines do not need to be sorted, and may overlap.
+     * @param lines The scanlines to store.
+     */
+    explicit ScanlineSet(const std::vector<geometrize::Scanline>& lines);
+
+    ~ScanlineSet() = default;
+    ScanlineSet& operator=(const ScanlineSet&) = default;
+    ScanlineSet(const ScanlineSet&) = default;
+    ScanlineSet& operator=(ScanlineSet&&) = default;
+    ScanlineSet(ScanlineSet&&) = default;
+
+    /**
+     * @brief empty Returns true if the set covers no pixels.
+     * @return True if the set is empty, else false.
+     */
+    bool empty() const;
+
+    /**
+     * @brief getSpanCount Gets the number of (merged) scanlines in the set.
+     * @return The number of scanlines in the set.
+     */
+    std::size_t getSpanCount() const;
+
+    /**
+     * @brief getPixelCount Gets the number of pixels covered by the set.
+     * @return The number of pixels covered by the set.
+     */
+    std::uint64_t getPixelCount() const;
+
+    /**
+     * @brief getBounds Gets the exact bounds of the pixels covered by the set. Meaningless if the set is empty.
+     * @return The bounds of the set.
+     */
+    const geometrize::BoundingBox& getBounds() const;
+
+    /**
+     * @brief isCompact Returns true if the set stores its x-coordinates as 16-bit values.
+     * @return True if the set uses compact storage, else false.
+     */
+    bool isCompact() const;
+
+    /**
+     * @brief forEachSpan Calls the given function for each scanline in the set, in row order and then left to right.
+     * @param f The function to call, with the signature void(std::int32_t y, std::int32_t x1, std::int32_t x2).
+     */
+    template<typename F> void forEachSpan(F f) const
+    {
+        if(m_compact) {
+            forEachSpan(m_compactX, f);
+        } else {
+            forEachSpan(m_x, f);
+        }
+    }
+
+    /**
+     * @brief overlaps Returns true if the given scanline covers any pixel in the set.
+     * @param line The scanline to test.
+     * @return True if the scanline overlaps the set, else false.
+     */
+    bool overlaps(const geometrize::Scanline& line) const;
+
+    /**
+     * @brief contains Returns true if every pixel of the given scanline is in the set.
+     * @param line The scanline to test.
+     * @return True if the set contains the scanline, else false.
+     */
+    bool contains(const geometrize::Scanline& line) const;
+
+    /**
+     * @brief overlaps Returns true if the two sets have any pixel in common. Takes time proportional to the scanlines on the rows the sets share.
+     * @param other The set to test.
+     * @return True if the sets overlap, else false.
+     */
+    bool overlaps(const geometrize::ScanlineSet& other) const;
+
+    /**
+     * @brief contains Returns true if every pixel in the other set is in this set. Takes time proportional to the scanlines on the rows the sets share.
+     * @param other The set to test.
+     * @return True if this set wholly contains the other set, else false.
+     */
+    bool contains(const geometrize::ScanlineSet& other) const;
+
+    /**
+     * @brief toScanlines Converts the set back to a vector of scanlines, in row order.
+     * @return The scanlines in the set.
+     */
+    std::vector<geometrize::Scanline> toScanlines() const;
+
+private:
+    template<typename T, typename F> void forEachSpan(const std::vector<T>& xs, F f) const
+    {
+        for(std::size_t row = 0; row + 1 < m_rowOffsets.size(); row++) {
+            const std::int32_t y{m_bounds.yMin + static_cast<std::int32_t>(row)};
+            for(std::uint32_t span = m_rowOffsets[row]; span < m_rowOffsets[row + 1]; span++) {
+                f(y, static_cast<std::int32_t>(xs[span * 2U]), static_cast<std::int32_t>(xs[span * 2U + 1U]));
+            }
+        }
+    }
+
+    std::int32_t getX1(std::uint32_t span) const;
+    std::int32_t getX2(std::uint32_t span) const;
+    bool findRow(std::int32_t y, std::uint32_t& begin, std::uint32_t& end) const;
+
+    geometrize::BoundingBox m_bounds; ///< The exact bounds of the pixels in the set.
+    std::uint64_t m_pixelCount; ///< The number of pixels in the set.
+    std::vector<std::uint32_t> m_rowOffsets; ///< Offsets of the first scanline on each row from the top of the bounds, plus a final end offset.
+    std::vector<std::int16_t> m_compactX; ///< Interleaved x1, x2 coordinates of the scanlines, used when the set is compact.
+    std::vector<std::int32_t> m_x; ///< Interleaved x1, x2 coordinates of the scanlines, used when the set is not compact.
+    bool m_compact; ///< Whether the x-coordinates are stored in m_compactX.
+};
+
+/**
+ * @brief forEachSpan Calls the given function for each scanline in the vector, in the order they are stored.
+ * Lets pixel kernels be written once for both vectors of scanlines and scanline sets.
+ * @param lines The scanlines.
+ * @param f The function to call, with the signature void(std::int32_t y, std::int32_t x1, std::int32_t x2).
+ */
+template<typename F> void forEachSpan(const std::vector<geometrize::Scanline>& lines, F f)
+{
+    for(const geometrize::Scanline& line : lines) {
+        f(line.y, line.x1, line.x2);
+    }
+}
+
+/**
+ * @brief forEachSpan Calls the given function for each scanline in the set, in row order.
+ * @param lines The scanline set.
+ * @param f The function to call, with the signature void(std::int32_t y, std::int32_t x1, std::int32_t x2).
+ */
+template<typename F> void forEachSpan(const geometrize::ScanlineSet& lines, F f)
+{
+    lines.forEachSpan(f);
+}
+
+}
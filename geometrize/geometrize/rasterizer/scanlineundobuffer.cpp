@@ -0,0 +1,53 @@
+#include "scanlineundobuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../bitmap/bitmap.h"
+#include "scanline.h"
+
+namespace geometrize
+{
+
+void ScanlineUndoBuffer::save(const geometrize::Bitmap& bitmap, const std::vector<geometrize::Scanline>& lines)
+{
+    m_lines.assign(lines.begin(), lines.end());
+
+    std::size_t size{0};
+    for(const geometrize::Scanline& line : lines) {
+        size += static_cast<std::size_t>(line.x2 - line.x1 + 1) * 4U;
+    }
+    m_pixels.resize(size);
+
+    std::uint8_t* pixels{m_pixels.data()};
+    for(const geometrize::Scanline& line : lines) {
+        const std::uint8_t* const span{bitmap.span(line.y, line.x1, line.x2)};
+        const std::size_t spanSize{static_cast<std::size_t>(line.x2 - line.x1 + 1) * 4U};
+        std::copy(span, span + spanSize, pixels);
+        pixels += spanSize;
+    }
+}
+
+void ScanlineUndoBuffer::restore(geometrize::Bitmap& bitmap) const
+{
+    const std::uint8_t* pixels{m_pixels.data()};
+    for(const geometrize::Scanline& line : m_lines) {
+        const std::size_t spanSize{static_cast<std::size_t>(line.x2 - line.x1 + 1) * 4U};
+        std::copy(pixels, pixels + spanSize, bitmap.writableSpan(line.y, line.x1, line.x2));
+        pixels += spanSize;
+    }
+}
+
+const std::vector<geometrize::Scanline>& ScanlineUndoBuffer::getLines() const
+{
+    return m_lines;
+}
+
+const std::uint8_t* ScanlineUndoBuffer::getPixels() const
+{
+    return m_pixels.data();
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "scanline.h"
+
+namespace geometrize
+{
+class Bitmap;
+}
+
+namespace geometrize
+{
+
+/**
+ * @brief The ScanlineUndoBuffer class saves the pixels of a bitmap under a set of scanlines, so they can be put back after drawing over them.
+ * Only the pixels under the scanlines are kept, packed in scanline order, so saving costs time and memory proportional to the size of the shape rather than of the bitmap.
+ * The buffer keeps its storage between saves, so reusing one buffer avoids allocating memory once it has grown large enough.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class ScanlineUndoBuffer
+{
+public:
+    ScanlineUndoBuffer() = default;
+    ~ScanlineUndoBuffer() = default;
+    ScanlineUndoBuffer& operator=(const ScanlineUndoBuffer&) = default;
+    ScanlineUndoBuffer(const ScanlineUndoBuffer&) = default;
+
+    /**
+     * @brief save Saves the pixels of the bitmap under the given scanlines, replacing anything saved before.
+     * @param bitmap The bitmap to save the pixels of.
+     * @param lines The scanlines, which must lie within the bitmap (trimmed).
+     */
+    void save(const geometrize::Bitmap& bitmap, const std::vector<geometrize::Scanline>& lines);
+
+    /**
+     * @brief restore Puts the saved pixels back into the bitmap, undoing any drawing under the saved scanlines since they were saved.
+     * @param bitmap The bitmap to put the pixels into, which must be writable and at least as large as the one they were saved from.
+     */
+    void restore(geometrize::Bitmap& bitmap) const;
+
+    /**
+     * @brief getLines Gets the scanlines the pixels were saved from.
+     * @return The saved scanlines.
+     */
+    const std::vector<geometrize::Scanline>& getLines() const;
+
+    /**
+     * @brief getPixels Gets the saved pixels, as RGBA8888 data packed in scanline order.
+     * @return The first byte of the saved pixels.
+     */
+    const std::uint8_t* getPixels() const;
+
+private:
+    std::vector<geometrize::Scanline> m_lines; ///< The scanlines the pixels were saved from.
+    std::vector<std::uint8_t> m_pixels; ///< The saved pixels, packed in scanline order.
+};
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace geometrize
+{
+
+/**
+ * @brief The SpanBatch struct holds the spans of a batch of shapes that were rasterized together, row by row.
+ * The spans are kept as a struct of arrays, with the spans of every shape on a row next to each other, so the shapes can be scored together in one sweep down the image.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+struct SpanBatch
+{
+    static const std::size_t MAX_SHAPES{8}; ///< The maximum number of shapes in a batch.
+
+    std::size_t shapeCount; ///< The number of shapes in the batch.
+    std::int32_t yMin; ///< The first row covered by any of the shapes.
+    std::int32_t yMax; ///< The last row covered by any of the shapes, less than yMin if they cover none.
+    std::vector<std::int32_t> x1; ///< The leftmost x-coordinate of the span of each shape on each row, the span of shape k on row y is at (y - yMin) * shapeCount + k.
+    std::vector<std::int32_t> x2; ///< The rightmost x-coordinate of the span of each shape on each row, less than x1 where the shape does not cover the row.
+};
+
+}
@@ -1,16 +1,25 @@
 #include "imagerunner.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "../bitmap/bitmap.h"
+#include "../bitmap/bitmappyramid.h"
 #include "../commonutil.h"
 #include "../core.h"
 #include "../model.h"
+#include "../rasterizer/scanline.h"
+#include "../rasterizer/scanlineset.h"
 #include "../shape/shape.h"
 #include "../shape/shapefactory.h"
+#include "../shape/shapemutator.h"
 #include "../shape/shapetypes.h"
+#include "../targetcache.h"
 #include "imagerunneroptions.h"
 
 namespace geometrize
@@ -20,7 +29,9 @@ class ImageRunner::ImageRunnerImpl
 {
 public:
     ImageRunnerImpl(const geometrize::Bitmap& targetBitmap) : m_model{targetBitmap} {}
-    ImageRunnerImpl(const geometrize::Bitmap& targetBitmap, const geometrize::Bitmap& initialBitmap) : m_model{targetBitmap, initialBitmap} {}
+    ImageRunnerImpl(const geometrize::Bitmap& targetBitmap, geometrize::Bitmap initialBitmap) : m_model{targetBitmap, std::move(initialBitmap)} {}
+    ImageRunnerImpl(const std::shared_ptr<const geometrize::Bitmap>& targetBitmap) : m_model{targetBitmap} {}
+    ImageRunnerImpl(const std::shared_ptr<const geometrize::Bitmap>& targetBitmap, geometrize::Bitmap initialBitmap) : m_model{targetBitmap, std::move(initialBitmap)} {}
     ~ImageRunnerImpl() = default;
     ImageRunnerImpl& operator=(const ImageRunnerImpl&) = delete;
     ImageRunnerImpl(const ImageRunnerImpl&) = delete;
@@ -30,14 +41,17 @@ public:
                                               geometrize::core::EnergyFunction energyFunction,
                                               geometrize::ShapeAcceptancePreconditionFunction addShapePrecondition)
     {
-        const auto [xMin, yMin, xMax, yMax] = geometrize::commonutil::mapShapeBoundsToImage(options.shapeBounds, m_model.getTarget());
+        const auto [xMin, yMin, xMax, yMax] = geometrize::commonutil::mapShapeBoundsToImage(options.shapeBounds, *m_model.getSharedTarget());
         const geometrize::ShapeTypes types = options.shapeTypes;
 
+        m_model.setSeed(options.seed);
         if(!shapeCreator) {
-            shapeCreator = geometrize::createDefaultShapeCreator(types, xMin, yMin, xMax, yMax);
+            const std::uint32_t factor{getCoarseToFineFactor(options.coarseToFine)};
+            if(factor > 1U) {
+                return stepCoarse(options, factor, xMin, yMin, xMax, yMax, energyFunction, addShapePrecondition);
+            }
+            return m_model.step(types, xMin, yMin, xMax, yMax, options.alpha, options.shapeCount, options.maxShapeMutations, options.maxThreads, energyFunction, addShapePrecondition);
         }
-
-        m_model.setSeed(options.seed);
         return m_model.step(shapeCreator, options.alpha, options.shapeCount, options.maxShapeMutations, options.maxThreads, energyFunction, addShapePrecondition);
     }
 
@@ -46,6 +60,12 @@ public:
         return m_model.getCurrent();
     }
 
+    void currentChanged()
+    {
+        m_model.currentChanged();
+        m_coarseModel = nullptr; // The reduced resolution image no longer matches, so start it again from the full resolution image
+    }
+
     geometrize::Bitmap& getTarget()
     {
         return m_model.getTarget();
@@ -67,15 +87,105 @@ public:
     }
 
 private:
+    std::uint32_t getCoarseToFineFactor(const geometrize::ImageRunnerCoarseToFineOptions& options) const
+    {
+        if(!options.enabled) {
+            return 1U;
+        }
+        if(m_coarseStepCount < options.quarterResolutionSteps) {
+            return 4U;
+        }
+        if(m_coarseStepCount - options.quarterResolutionSteps < options.halfResolutionSteps) {
+            return 2U;
+        }
+        return 1U;
+    }
+
+    std::vector<geometrize::ShapeResult> stepCoarse(const geometrize::ImageRunnerOptions& options,
+                                                    const std::uint32_t factor,
+                                                    const std::int32_t xMin,
+                                                    const std::int32_t yMin,
+                                                    const std::int32_t xMax,
+                                                    const std::int32_t yMax,
+                                                    const geometrize::core::EnergyFunction& energyFunction,
+                                                    const geometrize::ShapeAcceptancePreconditionFunction& addShapePrecondition)
+    {
+        // Start each resolution from the full resolution image as it stands, so it carries on from the shapes found so far
+        // The shrunk current image is taken from a pyramid the model keeps in step with it, and the shrunk target is shared with any other image runners using the same target
+        if(!m_coarseModel || m_coarseFactor != factor) {
+            m_coarseModel = std::unique_ptr<geometrize::Model>(new geometrize::Model(
+                        geometrize::TargetCache::get(m_model.getSharedTarget())->getDownsampled(factor),
+                        getShrunkCurrent(factor)));
+            m_coarseFactor = factor;
+        }
+        m_coarseStepCount++;
+
+        const auto [coarseXMin, coarseYMin, coarseXMax, coarseYMax] = geometrize::commonutil::mapShapeBoundsToImage(options.shapeBounds, *m_coarseModel->getSharedTarget());
+        m_coarseModel->setSeed(options.seed);
+        const std::vector<geometrize::ShapeResult> coarseResults{m_coarseModel->step(options.shapeTypes, coarseXMin, coarseYMin, coarseXMax, coarseYMax,
+                                                                                     options.alpha, options.shapeCount, options.maxShapeMutations, options.maxThreads,
+                                                                                     energyFunction, addShapePrecondition)};
+
+        // Scale the shapes up and re-score them against the full resolution target, keeping only those that still improve the image
+        std::vector<geometrize::ShapeResult> results;
+        for(const geometrize::ShapeResult& result : coarseResults) {
+            std::vector<geometrize::Scanline> changedLines{result.shape->rasterize(*result.shape)};
+            geometrize::resample(*result.shape, static_cast<float>(factor), static_cast<float>(factor));
+            geometrize::assignDefaultShapeFunctions(*result.shape, xMin, yMin, xMax, yMax);
+            const std::vector<geometrize::ShapeResult> added{m_model.addShape(result.shape, result.color, addShapePrecondition)};
+            if(!added.empty()) {
+                for(const geometrize::Scanline& line : result.shape->rasterize(*result.shape)) {
+                    changedLines.push_back(geometrize::Scanline(line.y / static_cast<std::int32_t>(factor), line.x1 / static_cast<std::int32_t>(factor), line.x2 / static_cast<std::int32_t>(factor)));
+                }
+            }
+            results.insert(results.end(), added.begin(), added.end());
+
+            // The reduced resolution image only differs from the shrunk full resolution image under the coarse shape and under the shape added at full resolution, if any,
+            // so copying those pixels across drops a rejected shape and keeps both images filtered the same way
+            m_coarseModel->copyLines(getShrunkCurrent(factor), geometrize::ScanlineSet(changedLines).toScanlines());
+        }
+        return results;
+    }
+
+    const geometrize::Bitmap& getShrunkCurrent(const std::uint32_t factor)
+    {
+        std::uint32_t levelCount{0U};
+        while((1U << levelCount) < factor) {
+            levelCount++;
+        }
+        const geometrize::BitmapPyramid& pyramid{m_model.getCurrentPyramid(levelCount)};
+        if(pyramid.getLevelCount() == 0U) {
+            return m_model.getCurrent(); // Already 1x1 pixels or less
+        }
+        return pyramid.getLevel((std::min)(static_cast<std::size_t>(levelCount), pyramid.getLevelCount()));
+    }
+
     geometrize::Model m_model; ///< The model for the primitive optimization/fitting algorithm.
+    std::unique_ptr<geometrize::Model> m_coarseModel; ///< The model used while taking steps at reduced resolution, if any.
+    std::uint32_t m_coarseFactor{1U}; ///< The factor the target image is shrunk by for the reduced resolution model.
+    std::uint32_t m_coarseStepCount{0U}; ///< The number of steps taken at reduced resolution.
 };
 
 ImageRunner::ImageRunner(const geometrize::Bitmap& targetBitmap) :
     d{std::unique_ptr<ImageRunner::ImageRunnerImpl>(new ImageRunner::ImageRunnerImpl(targetBitmap))}
 {}
 
-ImageRunner::ImageRunner(const geometrize::Bitmap& targetBitmap,  const geometrize::Bitmap& initialBitmap) :
-    d{std::unique_ptr<ImageRunner::ImageRunnerImpl>(new ImageRunner::ImageRunnerImpl(targetBitmap, initialBitmap))}
+ImageRunner::ImageRunner(const geometrize::Bitmap& targetBitmap, geometrize::Bitmap initialBitmap) :
+    d{std::unique_ptr<ImageRunner::ImageRunnerImpl>(new ImageRunner::ImageRunnerImpl(targetBitmap, std::move(initialBitmap)))}
+{}
+
+ImageRunner::ImageRunner(const geometrize::BitmapView& targetBitmap) : ImageRunner(geometrize::Bitmap(targetBitmap))
+{}
+
+ImageRunner::ImageRunner(const geometrize::BitmapView& targetBitmap, geometrize::Bitmap initialBitmap) : ImageRunner(geometrize::Bitmap(targetBitmap), std::move(initialBitmap))
+{}
+
+ImageRunner::ImageRunner(const std::shared_ptr<const geometrize::Bitmap>& targetBitmap) :
+    d{std::unique_ptr<ImageRunner::ImageRunnerImpl>(new ImageRunner::ImageRunnerImpl(targetBitmap))}
+{}
+
+ImageRunner::ImageRunner(const std::shared_ptr<const geometrize::Bitmap>& targetBitmap, geometrize::Bitmap initialBitmap) :
+    d{std::unique_ptr<ImageRunner::ImageRunnerImpl>(new ImageRunner::ImageRunnerImpl(targetBitmap, std::move(initialBitmap)))}
 {}
 
 ImageRunner::~ImageRunner()
@@ -94,6 +204,11 @@ geometrize::Bitmap& ImageRunner::getCurrent()
     return d->getCurrent();
 }
 
+void ImageRunner::currentChanged()
+{
+    d->currentChanged();
+}
+
 geometrize::Bitmap& ImageRunner::getTarget()
 {
     return d->getTarget();
@@ -106,7 +221,17 @@ const geometrize::Bitmap& ImageRunner::getCurrent() const
 
 const geometrize::Bitmap& ImageRunner::getTarget() const
 {
-    return d->getTarget();
+    return std::as_const(*d).getTarget(); // The non-const overload would take a private copy of a shared target
+}
+
+geometrize::BoundingBox ImageRunner::getDirtyRegion() const
+{
+    return d->getModel().getDirtyRegion();
+}
+
+void ImageRunner::clearDirtyRegion()
+{
+    d->getModel().clearDirtyRegion();
 }
 
 geometrize::Model& ImageRunner::getModel()
@@ -11,6 +11,7 @@
 namespace geometrize
 {
 class Bitmap;
+class BitmapView;
 class ImageRunnerOptions;
 class Shape;
 }
@@ -37,13 +38,45 @@ public:
      * @param targetBitmap The target bitmap to replicate with shapes.
      * @param initialBitmap The starting bitmap.
      */
-    ImageRunner(const geometrize::Bitmap& targetBitmap, const geometrize::Bitmap& initialBitmap);
+    ImageRunner(const geometrize::Bitmap& targetBitmap, geometrize::Bitmap initialBitmap);
+
+    /**
+     * @brief ImageRunner Creates an image runner that reads the target bitmap directly from the memory of the view, rather than copying it.
+     * Uses the average color of the target as the starting image. The pixel data of the view must outlive the image runner.
+     * @param targetBitmap A view of the target bitmap to replicate with shapes.
+     */
+    ImageRunner(const geometrize::BitmapView& targetBitmap);
+
+    /**
+     * @brief ImageRunner Creates an image runner that reads the target bitmap directly from the memory of the view, starting from the given initial bitmap.
+     * The target bitmap and initial bitmap must be the same size (width and height). The pixel data of the view must outlive the image runner.
+     * @param targetBitmap A view of the target bitmap to replicate with shapes.
+     * @param initialBitmap The starting bitmap.
+     */
+    ImageRunner(const geometrize::BitmapView& targetBitmap, geometrize::Bitmap initialBitmap);
+
+    /**
+     * @brief ImageRunner Creates an image runner that shares the given target bitmap rather than copying it. Uses the average color of the target as the starting image.
+     * Many image runners can share one target, and data derived from the target, such as the shrunk copies used for coarse to fine steps, is computed once for all of them.
+     * @param targetBitmap The target bitmap to replicate with shapes, must not be changed while the image runner uses it.
+     */
+    ImageRunner(const std::shared_ptr<const geometrize::Bitmap>& targetBitmap);
+
+    /**
+     * @brief ImageRunner Creates an image runner that shares the given target bitmap rather than copying it, starting from the given initial bitmap.
+     * The target bitmap and initial bitmap must be the same size (width and height).
+     * @param targetBitmap The target bitmap to replicate with shapes, must not be changed while the image runner uses it.
+     * @param initialBitmap The starting bitmap. Move in a bitmap that maps a writable file to keep the current bitmap in the file, rather than in memory.
+     */
+    ImageRunner(const std::shared_ptr<const geometrize::Bitmap>& targetBitmap, geometrize::Bitmap initialBitmap);
     ~ImageRunner();
     ImageRunner& operator=(const ImageRunner&) = delete;
     ImageRunner(const ImageRunner&) = delete;
 
     /**
      * @brief step Updates the internal model once.
+     * If coarse to fine stepping is enabled in the options and no shape creator is given, the first steps fit shapes to shrunk copies of the target, and the
+     * shapes found are scaled up and drawn on the full resolution image. The results returned are always in the coordinates of the full resolution image.
      * @param options Various configurable settings for doing the step e.g. the shape types to consider.
      * @param shapeCreator An optional function for creating and mutating shapes
      * @param energyFunction An optional function to calculate the energy (if unspecified a default implementation is used).
@@ -56,11 +89,16 @@ public:
                                               geometrize::ShapeAcceptancePreconditionFunction addShapePrecondition = nullptr);
 
     /**
-     * @brief getCurrent Gets the current bitmap with the primitives drawn on it.
+     * @brief getCurrent Gets the current bitmap with the primitives drawn on it. If its pixels are changed through the reference, call currentChanged() afterwards.
      * @return The current bitmap.
      */
     geometrize::Bitmap& getCurrent();
 
+    /**
+     * @brief currentChanged Tells the runner that the pixels of the current bitmap were changed through getCurrent(), see Model::currentChanged.
+     */
+    void currentChanged();
+
     /**
      * @brief getTarget Gets the target bitmap.
      * @return The target bitmap.
@@ -79,6 +117,17 @@ public:
      */
     const geometrize::Bitmap& getTarget() const;
 
+    /**
+     * @brief getDirtyRegion Gets the bounds of the pixels of the current bitmap that changed since the dirty region was last cleared, see Model::getDirtyRegion.
+     * @return The dirty region, which is empty (xMax < xMin) if nothing changed.
+     */
+    geometrize::BoundingBox getDirtyRegion() const;
+
+    /**
+     * @brief clearDirtyRegion Empties the dirty region, typically after the changed pixels have been copied.
+     */
+    void clearDirtyRegion();
+
     /**
      * @brief getModel Gets the underlying model.
      * @return The model.
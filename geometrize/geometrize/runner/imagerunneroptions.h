@@ -20,6 +20,18 @@ struct ImageRunnerShapeBoundsOptions {
     double yMaxPercent = 100.0;
 };
 
+/**
+ * @brief The ImageRunnerCoarseToFineOptions struct encapsulates options for fitting the first shapes to shrunk copies of the target image, which is far cheaper per step.
+ * Shapes found on a shrunk image are scaled up to the target resolution, drawn and re-scored against the full resolution target, and later steps keep refining from there.
+ * Only used when the image runner is stepped without a custom shape creator.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+struct ImageRunnerCoarseToFineOptions {
+    bool enabled = false; // Whether to take the first steps at reduced resolution
+    std::uint32_t quarterResolutionSteps = 100U; // The number of steps to take at a quarter of the resolution of the target image
+    std::uint32_t halfResolutionSteps = 100U; // The number of steps to take at half the resolution of the target image, after those at a quarter
+};
+
 /**
  * @brief The ImageRunnerOptions class encapsulates preferences/options that the image runner uses.
  * @author Sam Twidale (https://samcodes.co.uk/)
@@ -34,6 +46,7 @@ public:
     std::uint32_t seed = 9001U; ///< The seed for the random number generators used by the image runner.
     std::uint32_t maxThreads = 0; ///< The maximum number of separate threads for the implementation to use. 0 lets the implementation choose a reasonable number.
     ImageRunnerShapeBoundsOptions shapeBounds{}; ///< If zero or do not form a rectangle, the entire target image is used i.e. (0, 0, imageWidth, imageHeight)
+    ImageRunnerCoarseToFineOptions coarseToFine{}; ///< Options for taking the first steps at a quarter and then half of the resolution of the target image.
 };
 
 }
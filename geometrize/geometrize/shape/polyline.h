@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -10,6 +11,114 @@
 namespace geometrize
 {
 
+/**
+ * @brief The PolylinePoints class holds the points of a polyline, with the parts of the std::vector interface that the shape algorithms use.
+ * Up to INLINE_CAPACITY points are stored inline, so copying a typical polyline does not allocate. Larger polylines spill over into heap storage.
+ */
+class PolylinePoints
+{
+public:
+    static const std::size_t INLINE_CAPACITY{16}; ///< The number of points that are stored without allocating memory.
+
+    PolylinePoints() = default;
+
+    PolylinePoints(const std::vector<std::pair<float, float>>& points)
+    {
+        *this = points;
+    }
+
+    PolylinePoints& operator=(const std::vector<std::pair<float, float>>& points)
+    {
+        clear();
+        reserve(points.size());
+        for(const std::pair<float, float>& point : points) {
+            push_back(point);
+        }
+        return *this;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void clear()
+    {
+        m_size = 0;
+        m_overflow.clear();
+    }
+
+    void reserve(const std::size_t capacity)
+    {
+        if(capacity > INLINE_CAPACITY) {
+            m_overflow.reserve(capacity);
+        }
+    }
+
+    void push_back(const std::pair<float, float>& point)
+    {
+        if(m_size < INLINE_CAPACITY) {
+            m_inline[m_size++] = point;
+            return;
+        }
+        if(m_size == INLINE_CAPACITY) {
+            m_overflow.assign(m_inline, m_inline + INLINE_CAPACITY);
+        }
+        m_overflow.push_back(point);
+        m_size++;
+    }
+
+    std::pair<float, float>& operator[](const std::size_t i)
+    {
+        return data()[i];
+    }
+
+    const std::pair<float, float>& operator[](const std::size_t i) const
+    {
+        return data()[i];
+    }
+
+    std::pair<float, float>* data()
+    {
+        return m_size > INLINE_CAPACITY ? m_overflow.data() : m_inline;
+    }
+
+    const std::pair<float, float>* data() const
+    {
+        return m_size > INLINE_CAPACITY ? m_overflow.data() : m_inline;
+    }
+
+    std::pair<float, float>* begin()
+    {
+        return data();
+    }
+
+    std::pair<float, float>* end()
+    {
+        return data() + m_size;
+    }
+
+    const std::pair<float, float>* begin() const
+    {
+        return data();
+    }
+
+    const std::pair<float, float>* end() const
+    {
+        return data() + m_size;
+    }
+
+private:
+    std::pair<float, float> m_inline[INLINE_CAPACITY]; ///< Storage for the points while there are no more than INLINE_CAPACITY of them.
+    std::vector<std::pair<float, float>> m_overflow; ///< Storage for all of the points once there are more than INLINE_CAPACITY of them, otherwise empty.
+    std::size_t m_size{0}; ///< The number of points.
+};
+
 /**
  * @brief The Polyline class represents a polyline.
  * @author Sam Twidale (https://samcodes.co.uk/)
@@ -23,7 +132,7 @@ public:
     virtual std::shared_ptr<geometrize::Shape> clone() const override;
     virtual geometrize::ShapeTypes getType() const override;
 
-    std::vector<std::pair<float, float>> m_points; ///< The points on the polyline.
+    geometrize::PolylinePoints m_points; ///< The points on the polyline.
 };
 
 }
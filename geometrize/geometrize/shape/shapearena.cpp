@@ -0,0 +1,42 @@
+#include "shapearena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "shape.h"
+#include "shapefactory.h"
+#include "shapetypes.h"
+#include "shapevalue.h"
+
+namespace geometrize
+{
+
+ShapeArena::ShapeArena(const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax) :
+    m_xMin{xMin}, m_yMin{yMin}, m_xMax{xMax}, m_yMax{yMax}
+{
+}
+
+std::shared_ptr<geometrize::Shape> ShapeArena::acquire(const geometrize::ShapeTypes type)
+{
+    for(const std::shared_ptr<geometrize::Shape>& shape : m_shapes) {
+        if(shape.use_count() == 1 && shape->getType() == type) {
+            // Clear the parameters left over from the last use, notably the points of polylines, without giving up the memory they use
+            geometrize::assignShapeValue(*shape, geometrize::createShapeValue(type));
+            return shape;
+        }
+    }
+
+    std::shared_ptr<geometrize::Shape> shape{geometrize::create(type)};
+    geometrize::assignDefaultShapeFunctions(*shape, m_xMin, m_yMin, m_xMax, m_yMax);
+    m_shapes.push_back(shape);
+    return shape;
+}
+
+std::size_t ShapeArena::getShapeCount() const
+{
+    return m_shapes.size();
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "shapetypes.h"
+
+namespace geometrize
+{
+class Shape;
+}
+
+namespace geometrize
+{
+
+/**
+ * @brief The ShapeArena class is a pool of reusable candidate shapes, meant to be owned by one thread for the duration of a model step.
+ * Shapes handed out by the arena are returned to it automatically once nothing but the arena refers to them, so generating many short-lived
+ * candidate shapes only allocates as many shapes as are alive at once. Shapes are given the default setup, mutate and rasterize functions when first created.
+ * The arena is not thread-safe.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class ShapeArena
+{
+public:
+    /**
+     * @brief ShapeArena Creates a new, empty shape arena.
+     * @param xMin The minimum x coordinate of the shapes created.
+     * @param yMin The minimum y coordinate of the shapes created.
+     * @param xMax The maximum x coordinate of the shapes created.
+     * @param yMax The maximum y coordinate of the shapes created.
+     */
+    ShapeArena(std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+    ~ShapeArena() = default;
+    ShapeArena& operator=(const ShapeArena&) = delete;
+    ShapeArena(const ShapeArena&) = delete;
+
+    /**
+     * @brief acquire Gets a shape of the given type with all of its parameters zeroed, reusing a free slot in the arena if there is one.
+     * @param type The type of shape to get, must be a single shape type.
+     * @return The shape. It is returned to the arena once the last reference to it outside of the arena is released.
+     */
+    std::shared_ptr<geometrize::Shape> acquire(geometrize::ShapeTypes type);
+
+    /**
+     * @brief getShapeCount Gets the number of shapes the arena has allocated, whether they are in use or not.
+     * @return The number of shapes in the arena.
+     */
+    std::size_t getShapeCount() const;
+
+private:
+    const std::int32_t m_xMin; ///< The minimum x coordinate of the shapes created.
+    const std::int32_t m_yMin; ///< The minimum y coordinate of the shapes created.
+    const std::int32_t m_xMax; ///< The maximum x coordinate of the shapes created.
+    const std::int32_t m_yMax; ///< The maximum y coordinate of the shapes created.
+    std::vector<std::shared_ptr<geometrize::Shape>> m_shapes; ///< The shapes allocated by the arena, a shape is free if the arena holds the only reference to it.
+};
+
+/**
+ * @brief ShapeSlotCreator Type alias for a function that creates a shape by taking a slot from a shape arena, rather than allocating a new shape.
+ * The shape should be taken from the arena using ShapeArena::acquire. The shape will be set up (randomized) by the caller.
+ */
+using ShapeSlotCreator = std::function<std::shared_ptr<geometrize::Shape>(geometrize::ShapeArena& arena)>;
+
+}
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "shape.h"
+#include "shapearena.h"
 #include "shapetypes.h"
 
 namespace geometrize
@@ -27,6 +28,24 @@ namespace geometrize
  */
 std::function<std::shared_ptr<geometrize::Shape>()> createDefaultShapeCreator(geometrize::ShapeTypes types, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 
+/**
+ * @brief createDefaultShapeSlotCreator Creates the default shape slot creator, which takes shapes of the given types from a shape arena instead of allocating them.
+ * Picks shape types using the random number generator the same way the default shape creator does.
+ * @param types The types of shapes to create.
+ * @return The default shape slot creator.
+ */
+geometrize::ShapeSlotCreator createDefaultShapeSlotCreator(geometrize::ShapeTypes types);
+
+/**
+ * @brief assignDefaultShapeFunctions Binds the default setup, mutate and rasterize methods of the given shape, the same way the default shape creator does.
+ * @param shape The shape.
+ * @param xMin The minimum x coordinate of the shape.
+ * @param yMin The minimum y coordinate of the shape.
+ * @param xMax The maximum x coordinate of the shape.
+ * @param yMax The maximum y coordinate of the shape.
+ */
+void assignDefaultShapeFunctions(geometrize::Shape& shape, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
 /**
  * @brief create Creates a new shape of the specified type.
  * @param t The type of shape to create.
@@ -47,4 +66,11 @@ std::shared_ptr<geometrize::Shape> randomShape();
  */
 std::shared_ptr<geometrize::Shape> randomShapeOf(geometrize::ShapeTypes t);
 
+/**
+ * @brief randomShapeTypeOf Picks a random shape type from the types supplied. Uses the random number generator the same way randomShapeOf does.
+ * @param t The types of shape to possibly pick.
+ * @return The shape type picked.
+ */
+geometrize::ShapeTypes randomShapeTypeOf(geometrize::ShapeTypes t);
+
 }
@@ -1,8 +1,10 @@
 #include "shapemutator.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cmath>
+#include <utility>
 
 #include "circle.h"
 #include "ellipse.h"
@@ -12,6 +14,7 @@
 #include "rectangle.h"
 #include "rotatedellipse.h"
 #include "rotatedrectangle.h"
+#include "shapevalue.h"
 #include "triangle.h"
 
 #include "../commonutil.h"
@@ -29,54 +32,16 @@ float wrapMinMax(const float x, const float minimum, const float maximum)
     return minimum + wrapMax(x - minimum, maximum - minimum);
 }
 
-}
-
-namespace geometrize
-{
-
-void setup(geometrize::Shape& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
-{
-    switch(s.getType()) {
-    case geometrize::ShapeTypes::RECTANGLE:
-        setup(static_cast<geometrize::Rectangle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
-        setup(static_cast<geometrize::RotatedRectangle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::TRIANGLE:
-        setup(static_cast<geometrize::Triangle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::ELLIPSE:
-        setup(static_cast<geometrize::Ellipse&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
-        setup(static_cast<geometrize::RotatedEllipse&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::CIRCLE:
-        setup(static_cast<geometrize::Circle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::LINE:
-        setup(static_cast<geometrize::Line&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
-        setup(static_cast<geometrize::QuadraticBezier&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::POLYLINE:
-        setup(static_cast<geometrize::Polyline&>(s), xMin, yMin, xMax, yMax);
-        break;
-    default:
-        assert(0 && "Bad shape type");
-    }
-}
+// The per-type setup and mutate algorithms, shared by the shape classes and the shape value types
 
-void setup(geometrize::Circle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupCircle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y = geometrize::commonutil::randomRange(yMin, yMax - 1);
     s.m_r = geometrize::commonutil::randomRange(1, 32);
 }
 
-void setup(geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupEllipse(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y = geometrize::commonutil::randomRange(yMin, yMax - 1);
@@ -84,7 +49,7 @@ void setup(geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t y
     s.m_ry = geometrize::commonutil::randomRange(1, 32);
 }
 
-void setup(geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupLine(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::pair<std::int32_t, std::int32_t> startingPoint{std::make_pair(geometrize::commonutil::randomRange(xMin, xMax), geometrize::commonutil::randomRange(yMin, yMax - 1))};
 
@@ -94,7 +59,7 @@ void setup(geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin
     s.m_y2 = geometrize::commonutil::clamp(startingPoint.second + geometrize::commonutil::randomRange(-32, 32), yMin, yMax - 1);
 }
 
-void setup(geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupPolyline(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::pair<std::int32_t, std::int32_t> startingPoint{std::make_pair(geometrize::commonutil::randomRange(xMin, xMax), geometrize::commonutil::randomRange(yMin, yMax - 1))};
     for(std::int32_t i = 0; i < 4; i++) {
@@ -106,7 +71,7 @@ void setup(geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t
     }
 }
 
-void setup(geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupQuadraticBezier(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x1 = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y1 = geometrize::commonutil::randomRange(yMin, yMax - 1);
@@ -116,7 +81,7 @@ void setup(geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::i
     s.m_y2 = geometrize::commonutil::randomRange(yMin, yMax - 1);
 }
 
-void setup(geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupRectangle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x1 = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y1 = geometrize::commonutil::randomRange(yMin, yMax - 1);
@@ -124,7 +89,7 @@ void setup(geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t
     s.m_y2 = geometrize::commonutil::clamp(static_cast<std::int32_t>(s.m_y1) + geometrize::commonutil::randomRange(1, 32), yMin, yMax - 1);
 }
 
-void setup(geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupRotatedEllipse(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y = geometrize::commonutil::randomRange(yMin, yMax - 1);
@@ -133,7 +98,7 @@ void setup(geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::in
     s.m_angle = geometrize::commonutil::randomRange(0, 360);
 }
 
-void setup(geometrize::RotatedRectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupRotatedRectangle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x1 = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y1 = geometrize::commonutil::randomRange(yMin, yMax - 1);
@@ -142,7 +107,7 @@ void setup(geometrize::RotatedRectangle& s, const std::int32_t xMin, const std::
     s.m_angle = geometrize::commonutil::randomRange(0, 360);
 }
 
-void setup(geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void setupTriangle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     s.m_x1 = geometrize::commonutil::randomRange(xMin, xMax - 1);
     s.m_y1 = geometrize::commonutil::randomRange(yMin, yMax - 1);
@@ -152,42 +117,7 @@ void setup(geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t
     s.m_y3 = s.m_y1 + geometrize::commonutil::randomRange(-32, 32);
 }
 
-void mutate(geometrize::Shape& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
-{
-    switch(s.getType()) {
-    case geometrize::ShapeTypes::RECTANGLE:
-        mutate(static_cast<geometrize::Rectangle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
-        mutate(static_cast<geometrize::RotatedRectangle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::TRIANGLE:
-        mutate(static_cast<geometrize::Triangle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::ELLIPSE:
-        mutate(static_cast<geometrize::Ellipse&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
-        mutate(static_cast<geometrize::RotatedEllipse&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::CIRCLE:
-        mutate(static_cast<geometrize::Circle&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::LINE:
-        mutate(static_cast<geometrize::Line&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
-        mutate(static_cast<geometrize::QuadraticBezier&>(s), xMin, yMin, xMax, yMax);
-        break;
-    case geometrize::ShapeTypes::POLYLINE:
-        mutate(static_cast<geometrize::Polyline&>(s), xMin, yMin, xMax, yMax);
-        break;
-    default:
-        assert(0 && "Bad shape type");
-    }
-}
-
-void mutate(geometrize::Circle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateCircle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 1)};
     switch(r) {
@@ -205,7 +135,7 @@ void mutate(geometrize::Circle& s, const std::int32_t xMin, const std::int32_t y
     }
 }
 
-void mutate(geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateEllipse(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 2)};
     switch(r) {
@@ -228,7 +158,7 @@ void mutate(geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t
     }
 }
 
-void mutate(geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateLine(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 1)};
 
@@ -248,18 +178,19 @@ void mutate(geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMi
     }
 }
 
-void mutate(geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutatePolyline(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t i{geometrize::commonutil::randomRange(static_cast<std::size_t>(0), s.m_points.size() - 1)};
 
-    std::pair<std::int32_t, std::int32_t> point{s.m_points[i]};
+    std::pair<std::int32_t, std::int32_t> point{static_cast<std::int32_t>(s.m_points[i].first), static_cast<std::int32_t>(s.m_points[i].second)};
     point.first = geometrize::commonutil::clamp(point.first + geometrize::commonutil::randomRange(-64, 64), xMin, xMax - 1);
     point.second = geometrize::commonutil::clamp(point.second + geometrize::commonutil::randomRange(-64, 64), yMin, yMax - 1);
 
-    s.m_points[i] = point;
+    s.m_points[i].first = static_cast<float>(point.first);
+    s.m_points[i].second = static_cast<float>(point.second);
 }
 
-void mutate(geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateQuadraticBezier(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 2)};
     switch(r) {
@@ -286,7 +217,7 @@ void mutate(geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::
     }
 }
 
-void mutate(geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateRectangle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 1)};
     switch(r) {
@@ -305,7 +236,7 @@ void mutate(geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_
     }
 }
 
-void mutate(geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateRotatedEllipse(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 3)};
     switch(r) {
@@ -333,7 +264,7 @@ void mutate(geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::i
     }
 }
 
-void mutate(geometrize::RotatedRectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateRotatedRectangle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 2)};
     switch(r) {
@@ -357,7 +288,7 @@ void mutate(geometrize::RotatedRectangle& s, const std::int32_t xMin, const std:
     }
 }
 
-void mutate(geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+template<typename T> void mutateTriangle(T& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
 {
     const std::int32_t r{geometrize::commonutil::randomRange(0, 2)};
     switch(r) {
@@ -382,6 +313,363 @@ void mutate(geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t
     }
 }
 
+/**
+* @brief resampleCoordinate Maps a coordinate on one canvas to the corresponding coordinate on a canvas of a different resolution, so pixel centres map onto pixel centres.
+* @param v The coordinate.
+* @param scaleFactor The ratio of the resolution of the new canvas to that of the old one.
+* @return The coordinate on the new canvas.
+*/
+float resampleCoordinate(const float v, const float scaleFactor)
+{
+    return (v + 0.5f) * scaleFactor - 0.5f;
+}
+
+/**
+* @brief resampleInclusiveCoordinate Maps a coordinate of a shape that covers the whole pixels from min to max inclusive to the corresponding coordinate on a canvas of a different resolution.
+* The pixel at min maps to the first of the pixels covering it on the new canvas, the pixel at max to the last, and coordinates in between are spread evenly.
+* @param v The coordinate, truncated to a whole pixel as the rasterizer does.
+* @param min The smallest coordinate of the shape along this axis.
+* @param max The largest coordinate of the shape along this axis.
+* @param scaleFactor The ratio of the resolution of the new canvas to that of the old one.
+* @return The coordinate on the new canvas.
+*/
+float resampleInclusiveCoordinate(const float v, const float min, const float max, const float scaleFactor)
+{
+    const float first{std::trunc(min)};
+    const float last{std::trunc(max)};
+    if(last <= first) {
+        return ::resampleCoordinate(first, scaleFactor); // Only one pixel wide, so keep it at the centre of the pixels covering it
+    }
+    const float newFirst{first * scaleFactor};
+    const float newLast{(last + 1.0f) * scaleFactor - 1.0f};
+    return newFirst + (std::trunc(v) - first) * (newLast - newFirst) / (last - first);
+}
+
+}
+
+namespace geometrize
+{
+
+void setup(geometrize::Shape& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    switch(s.getType()) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        setup(static_cast<geometrize::Rectangle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        setup(static_cast<geometrize::RotatedRectangle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::TRIANGLE:
+        setup(static_cast<geometrize::Triangle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ELLIPSE:
+        setup(static_cast<geometrize::Ellipse&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        setup(static_cast<geometrize::RotatedEllipse&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::CIRCLE:
+        setup(static_cast<geometrize::Circle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::LINE:
+        setup(static_cast<geometrize::Line&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        setup(static_cast<geometrize::QuadraticBezier&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::POLYLINE:
+        setup(static_cast<geometrize::Polyline&>(s), xMin, yMin, xMax, yMax);
+        break;
+    default:
+        assert(0 && "Bad shape type");
+    }
+}
+
+void setup(geometrize::Circle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupCircle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupLine(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupPolyline(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupQuadraticBezier(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupRotatedEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::RotatedRectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupRotatedRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupTriangle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::CircleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupCircle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::EllipseValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::LineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupLine(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::PolylineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupPolyline(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::QuadraticBezierValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupQuadraticBezier(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::RectangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::RotatedEllipseValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupRotatedEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::RotatedRectangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupRotatedRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::TriangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::setupTriangle(s, xMin, yMin, xMax, yMax);
+}
+
+void setup(geometrize::ShapeValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    switch(s.m_type) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        ::setupRectangle(s.m_rectangle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        ::setupRotatedRectangle(s.m_rotatedRectangle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::TRIANGLE:
+        ::setupTriangle(s.m_triangle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ELLIPSE:
+        ::setupEllipse(s.m_ellipse, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        ::setupRotatedEllipse(s.m_rotatedEllipse, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::CIRCLE:
+        ::setupCircle(s.m_circle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::LINE:
+        ::setupLine(s.m_line, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        ::setupQuadraticBezier(s.m_quadraticBezier, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::POLYLINE:
+        ::setupPolyline(s.m_polyline, xMin, yMin, xMax, yMax);
+        break;
+    default:
+        assert(0 && "Bad shape type");
+    }
+}
+
+void mutate(geometrize::Shape& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    switch(s.getType()) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        mutate(static_cast<geometrize::Rectangle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        mutate(static_cast<geometrize::RotatedRectangle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::TRIANGLE:
+        mutate(static_cast<geometrize::Triangle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ELLIPSE:
+        mutate(static_cast<geometrize::Ellipse&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        mutate(static_cast<geometrize::RotatedEllipse&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::CIRCLE:
+        mutate(static_cast<geometrize::Circle&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::LINE:
+        mutate(static_cast<geometrize::Line&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        mutate(static_cast<geometrize::QuadraticBezier&>(s), xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::POLYLINE:
+        mutate(static_cast<geometrize::Polyline&>(s), xMin, yMin, xMax, yMax);
+        break;
+    default:
+        assert(0 && "Bad shape type");
+    }
+}
+
+void mutate(geometrize::Circle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateCircle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::Ellipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::Line& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateLine(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::Polyline& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutatePolyline(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::QuadraticBezier& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateQuadraticBezier(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::Rectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::RotatedEllipse& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateRotatedEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::RotatedRectangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateRotatedRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::Triangle& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateTriangle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::CircleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateCircle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::EllipseValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::LineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateLine(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::PolylineValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutatePolyline(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::QuadraticBezierValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateQuadraticBezier(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::RectangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::RotatedEllipseValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateRotatedEllipse(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::RotatedRectangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateRotatedRectangle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::TriangleValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    ::mutateTriangle(s, xMin, yMin, xMax, yMax);
+}
+
+void mutate(geometrize::ShapeValue& s, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    switch(s.m_type) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        ::mutateRectangle(s.m_rectangle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        ::mutateRotatedRectangle(s.m_rotatedRectangle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::TRIANGLE:
+        ::mutateTriangle(s.m_triangle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ELLIPSE:
+        ::mutateEllipse(s.m_ellipse, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        ::mutateRotatedEllipse(s.m_rotatedEllipse, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::CIRCLE:
+        ::mutateCircle(s.m_circle, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::LINE:
+        ::mutateLine(s.m_line, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        ::mutateQuadraticBezier(s.m_quadraticBezier, xMin, yMin, xMax, yMax);
+        break;
+    case geometrize::ShapeTypes::POLYLINE:
+        ::mutatePolyline(s.m_polyline, xMin, yMin, xMax, yMax);
+        break;
+    default:
+        assert(0 && "Bad shape type");
+    }
+}
+
 void translate(geometrize::Shape& s, const float x, const float y)
 {
     switch(s.getType()) {
@@ -547,7 +835,7 @@ void scale(geometrize::Line& s, const float scaleFactor)
 
 void scale(geometrize::Polyline& s, const float scaleFactor)
 {
-    std::vector<std::pair<float, float>> points;
+    geometrize::PolylinePoints points;
 
     for(std::size_t i = 0; i < s.m_points.size(); i+=2) {
         if(i == s.m_points.size() - 1 || i == s.m_points.size()) {
@@ -692,4 +980,152 @@ void rotate(geometrize::Triangle& s, const float angle)
     translate(s, xMid, yMid);
 }
 
+
+void resample(geometrize::Shape& s, const float scaleX, const float scaleY)
+{
+    switch(s.getType()) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        resample(static_cast<geometrize::Rectangle&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        resample(static_cast<geometrize::RotatedRectangle&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::TRIANGLE:
+        resample(static_cast<geometrize::Triangle&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::ELLIPSE:
+        resample(static_cast<geometrize::Ellipse&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        resample(static_cast<geometrize::RotatedEllipse&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::CIRCLE:
+        resample(static_cast<geometrize::Circle&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::LINE:
+        resample(static_cast<geometrize::Line&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        resample(static_cast<geometrize::QuadraticBezier&>(s), scaleX, scaleY);
+        break;
+    case geometrize::ShapeTypes::POLYLINE:
+        resample(static_cast<geometrize::Polyline&>(s), scaleX, scaleY);
+        break;
+    default:
+        assert(0 && "Bad shape type");
+    }
+}
+
+void resample(geometrize::Circle& s, const float scaleX, const float scaleY)
+{
+    s.m_x = ::resampleCoordinate(s.m_x, scaleX);
+    s.m_y = ::resampleCoordinate(s.m_y, scaleY);
+    s.m_r *= std::sqrt(scaleX * scaleY);
+}
+
+void resample(geometrize::Ellipse& s, const float scaleX, const float scaleY)
+{
+    s.m_x = ::resampleCoordinate(s.m_x, scaleX);
+    s.m_y = ::resampleCoordinate(s.m_y, scaleY);
+    s.m_rx *= scaleX;
+    s.m_ry *= scaleY;
+}
+
+void resample(geometrize::Line& s, const float scaleX, const float scaleY)
+{
+    const float xMin{(std::min)(s.m_x1, s.m_x2)};
+    const float xMax{(std::max)(s.m_x1, s.m_x2)};
+    const float yMin{(std::min)(s.m_y1, s.m_y2)};
+    const float yMax{(std::max)(s.m_y1, s.m_y2)};
+    s.m_x1 = ::resampleInclusiveCoordinate(s.m_x1, xMin, xMax, scaleX);
+    s.m_y1 = ::resampleInclusiveCoordinate(s.m_y1, yMin, yMax, scaleY);
+    s.m_x2 = ::resampleInclusiveCoordinate(s.m_x2, xMin, xMax, scaleX);
+    s.m_y2 = ::resampleInclusiveCoordinate(s.m_y2, yMin, yMax, scaleY);
+}
+
+void resample(geometrize::Polyline& s, const float scaleX, const float scaleY)
+{
+    if(s.m_points.empty()) {
+        return;
+    }
+
+    float xMin{s.m_points[0].first};
+    float xMax{xMin};
+    float yMin{s.m_points[0].second};
+    float yMax{yMin};
+    for(const std::pair<float, float>& point : s.m_points) {
+        xMin = (std::min)(xMin, point.first);
+        xMax = (std::max)(xMax, point.first);
+        yMin = (std::min)(yMin, point.second);
+        yMax = (std::max)(yMax, point.second);
+    }
+
+    for(std::pair<float, float>& point : s.m_points) {
+        point.first = ::resampleInclusiveCoordinate(point.first, xMin, xMax, scaleX);
+        point.second = ::resampleInclusiveCoordinate(point.second, yMin, yMax, scaleY);
+    }
+}
+
+void resample(geometrize::QuadraticBezier& s, const float scaleX, const float scaleY)
+{
+    s.m_cx = ::resampleCoordinate(s.m_cx, scaleX);
+    s.m_cy = ::resampleCoordinate(s.m_cy, scaleY);
+    s.m_x1 = ::resampleCoordinate(s.m_x1, scaleX);
+    s.m_y1 = ::resampleCoordinate(s.m_y1, scaleY);
+    s.m_x2 = ::resampleCoordinate(s.m_x2, scaleX);
+    s.m_y2 = ::resampleCoordinate(s.m_y2, scaleY);
+}
+
+void resample(geometrize::Rectangle& s, const float scaleX, const float scaleY)
+{
+    // Rectangles cover the pixels from one corner to the other inclusive, so the far corner maps to the last pixel covering it
+    const float xMin{(std::min)(s.m_x1, s.m_x2)};
+    const float xMax{(std::max)(s.m_x1, s.m_x2)};
+    const float yMin{(std::min)(s.m_y1, s.m_y2)};
+    const float yMax{(std::max)(s.m_y1, s.m_y2)};
+    s.m_x1 = ::resampleInclusiveCoordinate(s.m_x1, xMin, xMax, scaleX);
+    s.m_y1 = ::resampleInclusiveCoordinate(s.m_y1, yMin, yMax, scaleY);
+    s.m_x2 = ::resampleInclusiveCoordinate(s.m_x2, xMin, xMax, scaleX);
+    s.m_y2 = ::resampleInclusiveCoordinate(s.m_y2, yMin, yMax, scaleY);
+}
+
+void resample(geometrize::RotatedEllipse& s, const float scaleX, const float scaleY)
+{
+    // A rotated ellipse stretched along the image axes is no longer the same rotated ellipse, so the radii take the mean scale
+    const float scaleFactor{std::sqrt(scaleX * scaleY)};
+    s.m_x = ::resampleCoordinate(s.m_x, scaleX);
+    s.m_y = ::resampleCoordinate(s.m_y, scaleY);
+    s.m_rx *= scaleFactor;
+    s.m_ry *= scaleFactor;
+}
+
+void resample(geometrize::RotatedRectangle& s, const float scaleX, const float scaleY)
+{
+    // The rectangle is rotated about its centre, so move the centre and scale the sides about it by the mean scale
+    const float scaleFactor{std::sqrt(scaleX * scaleY)};
+    const float xMid = (s.m_x1 + s.m_x2) / 2;
+    const float yMid = (s.m_y1 + s.m_y2) / 2;
+    const float newXMid = ::resampleCoordinate(xMid, scaleX);
+    const float newYMid = ::resampleCoordinate(yMid, scaleY);
+
+    s.m_x1 = (s.m_x1 - xMid) * scaleFactor + newXMid;
+    s.m_y1 = (s.m_y1 - yMid) * scaleFactor + newYMid;
+    s.m_x2 = (s.m_x2 - xMid) * scaleFactor + newXMid;
+    s.m_y2 = (s.m_y2 - yMid) * scaleFactor + newYMid;
+}
+
+void resample(geometrize::Triangle& s, const float scaleX, const float scaleY)
+{
+    const float xMin{(std::min)({s.m_x1, s.m_x2, s.m_x3})};
+    const float xMax{(std::max)({s.m_x1, s.m_x2, s.m_x3})};
+    const float yMin{(std::min)({s.m_y1, s.m_y2, s.m_y3})};
+    const float yMax{(std::max)({s.m_y1, s.m_y2, s.m_y3})};
+    s.m_x1 = ::resampleInclusiveCoordinate(s.m_x1, xMin, xMax, scaleX);
+    s.m_y1 = ::resampleInclusiveCoordinate(s.m_y1, yMin, yMax, scaleY);
+    s.m_x2 = ::resampleInclusiveCoordinate(s.m_x2, xMin, xMax, scaleX);
+    s.m_y2 = ::resampleInclusiveCoordinate(s.m_y2, yMin, yMax, scaleY);
+    s.m_x3 = ::resampleInclusiveCoordinate(s.m_x3, xMin, xMax, scaleX);
+    s.m_y3 = ::resampleInclusiveCoordinate(s.m_y3, yMin, yMax, scaleY);
+}
+
 }
@@ -14,6 +14,16 @@ class RotatedEllipse;
 class RotatedRectangle;
 class Shape;
 class Triangle;
+struct CircleValue;
+struct EllipseValue;
+struct LineValue;
+struct PolylineValue;
+struct QuadraticBezierValue;
+struct RectangleValue;
+struct RotatedEllipseValue;
+struct RotatedRectangleValue;
+struct TriangleValue;
+struct ShapeValue;
 }
 
 namespace geometrize
@@ -30,6 +40,16 @@ void setup(geometrize::Rectangle& s, std::int32_t xMin, std::int32_t yMin, std::
 void setup(geometrize::RotatedEllipse& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 void setup(geometrize::RotatedRectangle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 void setup(geometrize::Triangle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::CircleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::EllipseValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::LineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::PolylineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::QuadraticBezierValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::RectangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::RotatedEllipseValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::RotatedRectangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::TriangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void setup(geometrize::ShapeValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 
 // Default implementations that mutate each type of shape
 void mutate(geometrize::Shape& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
@@ -42,6 +62,16 @@ void mutate(geometrize::Rectangle& s, std::int32_t xMin, std::int32_t yMin, std:
 void mutate(geometrize::RotatedEllipse& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 void mutate(geometrize::RotatedRectangle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 void mutate(geometrize::Triangle& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::CircleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::EllipseValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::LineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::PolylineValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::QuadraticBezierValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::RectangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::RotatedEllipseValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::RotatedRectangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::TriangleValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+void mutate(geometrize::ShapeValue& s, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
 
 // Default implementations that translate each type of shape
 void translate(geometrize::Shape& s, float x, float y);
@@ -74,4 +104,18 @@ void rotate(geometrize::RotatedEllipse& s, float angle);
 void rotate(geometrize::RotatedRectangle& s, float angle);
 void rotate(geometrize::Triangle& s, float angle);
 
+// Default implementations that resample each type of shape from one canvas to a canvas of a different resolution, mapping pixel centres onto pixel centres
+// Rectangles, triangles, lines and polylines cover whole pixels between their vertices inclusive, so their extents are mapped onto all of the pixels covering them instead
+// Unlike scale, this moves the shape as well as resizing it. Rotated shapes and circles are resized by the geometric mean of the two factors
+void resample(geometrize::Shape& s, float scaleX, float scaleY);
+void resample(geometrize::Circle& s, float scaleX, float scaleY);
+void resample(geometrize::Ellipse& s, float scaleX, float scaleY);
+void resample(geometrize::Line& s, float scaleX, float scaleY);
+void resample(geometrize::Polyline& s, float scaleX, float scaleY);
+void resample(geometrize::QuadraticBezier& s, float scaleX, float scaleY);
+void resample(geometrize::Rectangle& s, float scaleX, float scaleY);
+void resample(geometrize::RotatedEllipse& s, float scaleX, float scaleY);
+void resample(geometrize::RotatedRectangle& s, float scaleX, float scaleY);
+void resample(geometrize::Triangle& s, float scaleX, float scaleY);
+
 }
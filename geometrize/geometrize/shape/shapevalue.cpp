@@ -0,0 +1,203 @@
+#include "shapevalue.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "circle.h"
+#include "ellipse.h"
+#include "line.h"
+#include "polyline.h"
+#include "quadraticbezier.h"
+#include "rectangle.h"
+#include "rotatedellipse.h"
+#include "rotatedrectangle.h"
+#include "shape.h"
+#include "shapefactory.h"
+#include "shapetypes.h"
+#include "triangle.h"
+
+static_assert(std::is_trivially_copyable<geometrize::ShapeValue>::value, "Shape values must be trivially copyable");
+
+namespace geometrize
+{
+
+geometrize::ShapeValue createShapeValue(const geometrize::ShapeTypes type)
+{
+    geometrize::ShapeValue value;
+    std::memset(&value, 0, sizeof(value));
+    value.m_type = type;
+    return value;
+}
+
+std::shared_ptr<geometrize::Shape> toShape(const geometrize::ShapeValue& value, const std::int32_t xMin, const std::int32_t yMin, const std::int32_t xMax, const std::int32_t yMax)
+{
+    std::shared_ptr<geometrize::Shape> shape{geometrize::create(value.m_type)};
+    assignShapeValue(*shape, value);
+    geometrize::assignDefaultShapeFunctions(*shape, xMin, yMin, xMax, yMax);
+    return shape;
+}
+
+void assignShapeValue(geometrize::Shape& shape, const geometrize::ShapeValue& value)
+{
+    assert(shape.getType() == value.m_type);
+
+    switch(value.m_type) {
+    case geometrize::ShapeTypes::RECTANGLE: {
+        const geometrize::RectangleValue& v{value.m_rectangle};
+        geometrize::Rectangle& s{static_cast<geometrize::Rectangle&>(shape)};
+        s.m_x1 = v.m_x1;
+        s.m_y1 = v.m_y1;
+        s.m_x2 = v.m_x2;
+        s.m_y2 = v.m_y2;
+        break;
+    }
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE: {
+        const geometrize::RotatedRectangleValue& v{value.m_rotatedRectangle};
+        geometrize::RotatedRectangle& s{static_cast<geometrize::RotatedRectangle&>(shape)};
+        s.m_x1 = v.m_x1;
+        s.m_y1 = v.m_y1;
+        s.m_x2 = v.m_x2;
+        s.m_y2 = v.m_y2;
+        s.m_angle = v.m_angle;
+        break;
+    }
+    case geometrize::ShapeTypes::TRIANGLE: {
+        const geometrize::TriangleValue& v{value.m_triangle};
+        geometrize::Triangle& s{static_cast<geometrize::Triangle&>(shape)};
+        s.m_x1 = v.m_x1;
+        s.m_y1 = v.m_y1;
+        s.m_x2 = v.m_x2;
+        s.m_y2 = v.m_y2;
+        s.m_x3 = v.m_x3;
+        s.m_y3 = v.m_y3;
+        break;
+    }
+    case geometrize::ShapeTypes::ELLIPSE: {
+        const geometrize::EllipseValue& v{value.m_ellipse};
+        geometrize::Ellipse& s{static_cast<geometrize::Ellipse&>(shape)};
+        s.m_x = v.m_x;
+        s.m_y = v.m_y;
+        s.m_rx = v.m_rx;
+        s.m_ry = v.m_ry;
+        break;
+    }
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE: {
+        const geometrize::RotatedEllipseValue& v{value.m_rotatedEllipse};
+        geometrize::RotatedEllipse& s{static_cast<geometrize::RotatedEllipse&>(shape)};
+        s.m_x = v.m_x;
+        s.m_y = v.m_y;
+        s.m_rx = v.m_rx;
+        s.m_ry = v.m_ry;
+        s.m_angle = v.m_angle;
+        break;
+    }
+    case geometrize::ShapeTypes::CIRCLE: {
+        const geometrize::CircleValue& v{value.m_circle};
+        geometrize::Circle& s{static_cast<geometrize::Circle&>(shape)};
+        s.m_x = v.m_x;
+        s.m_y = v.m_y;
+        s.m_r = v.m_r;
+        break;
+    }
+    case geometrize::ShapeTypes::LINE: {
+        const geometrize::LineValue& v{value.m_line};
+        geometrize::Line& s{static_cast<geometrize::Line&>(shape)};
+        s.m_x1 = v.m_x1;
+        s.m_y1 = v.m_y1;
+        s.m_x2 = v.m_x2;
+        s.m_y2 = v.m_y2;
+        break;
+    }
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER: {
+        const geometrize::QuadraticBezierValue& v{value.m_quadraticBezier};
+        geometrize::QuadraticBezier& s{static_cast<geometrize::QuadraticBezier&>(shape)};
+        s.m_cx = v.m_cx;
+        s.m_cy = v.m_cy;
+        s.m_x1 = v.m_x1;
+        s.m_y1 = v.m_y1;
+        s.m_x2 = v.m_x2;
+        s.m_y2 = v.m_y2;
+        break;
+    }
+    case geometrize::ShapeTypes::POLYLINE: {
+        const geometrize::PolylineValue& v{value.m_polyline};
+        geometrize::Polyline& s{static_cast<geometrize::Polyline&>(shape)};
+        s.m_points.clear();
+        s.m_points.reserve(v.m_points.size());
+        for(const geometrize::PolylineValuePoint& point : v.m_points) {
+            s.m_points.push_back(std::make_pair(point.first, point.second));
+        }
+        break;
+    }
+    default:
+        assert(0 && "Bad shape type");
+    }
+}
+
+bool fromShape(const geometrize::Shape& shape, geometrize::ShapeValue& value)
+{
+    value = createShapeValue(shape.getType());
+
+    switch(shape.getType()) {
+    case geometrize::ShapeTypes::RECTANGLE: {
+        const geometrize::Rectangle& s{static_cast<const geometrize::Rectangle&>(shape)};
+        value.m_rectangle = geometrize::RectangleValue{s.m_x1, s.m_y1, s.m_x2, s.m_y2};
+        return true;
+    }
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE: {
+        const geometrize::RotatedRectangle& s{static_cast<const geometrize::RotatedRectangle&>(shape)};
+        value.m_rotatedRectangle = geometrize::RotatedRectangleValue{s.m_x1, s.m_y1, s.m_x2, s.m_y2, s.m_angle};
+        return true;
+    }
+    case geometrize::ShapeTypes::TRIANGLE: {
+        const geometrize::Triangle& s{static_cast<const geometrize::Triangle&>(shape)};
+        value.m_triangle = geometrize::TriangleValue{s.m_x1, s.m_y1, s.m_x2, s.m_y2, s.m_x3, s.m_y3};
+        return true;
+    }
+    case geometrize::ShapeTypes::ELLIPSE: {
+        const geometrize::Ellipse& s{static_cast<const geometrize::Ellipse&>(shape)};
+        value.m_ellipse = geometrize::EllipseValue{s.m_x, s.m_y, s.m_rx, s.m_ry};
+        return true;
+    }
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE: {
+        const geometrize::RotatedEllipse& s{static_cast<const geometrize::RotatedEllipse&>(shape)};
+        value.m_rotatedEllipse = geometrize::RotatedEllipseValue{s.m_x, s.m_y, s.m_rx, s.m_ry, s.m_angle};
+        return true;
+    }
+    case geometrize::ShapeTypes::CIRCLE: {
+        const geometrize::Circle& s{static_cast<const geometrize::Circle&>(shape)};
+        value.m_circle = geometrize::CircleValue{s.m_x, s.m_y, s.m_r};
+        return true;
+    }
+    case geometrize::ShapeTypes::LINE: {
+        const geometrize::Line& s{static_cast<const geometrize::Line&>(shape)};
+        value.m_line = geometrize::LineValue{s.m_x1, s.m_y1, s.m_x2, s.m_y2};
+        return true;
+    }
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER: {
+        const geometrize::QuadraticBezier& s{static_cast<const geometrize::QuadraticBezier&>(shape)};
+        value.m_quadraticBezier = geometrize::QuadraticBezierValue{s.m_cx, s.m_cy, s.m_x1, s.m_y1, s.m_x2, s.m_y2};
+        return true;
+    }
+    case geometrize::ShapeTypes::POLYLINE: {
+        const geometrize::Polyline& s{static_cast<const geometrize::Polyline&>(shape)};
+        if(s.m_points.size() > geometrize::PolylineValuePoints::MAX_POINTS) {
+            return false;
+        }
+        for(const std::pair<float, float>& point : s.m_points) {
+            value.m_polyline.m_points.push_back(point);
+        }
+        return true;
+    }
+    default:
+        assert(0 && "Bad shape type");
+        return false;
+    }
+}
+
+}
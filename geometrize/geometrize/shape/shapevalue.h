@@ -0,0 +1,400 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "shapetypes.h"
+
+namespace geometrize
+{
+class Shape;
+}
+
+namespace geometrize
+{
+
+/**
+ * The value types in this file are trivially copyable counterparts of the shape classes.
+ * They hold the same parameters under the same member names as the shape classes, but no setup/mutate/rasterize functions,
+ * so copying one is a plain memory copy. They are used internally by the optimizer so hill climbing does not allocate per mutation.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+
+/**
+ * @brief The CircleValue struct holds the parameters of a circle.
+ */
+struct CircleValue
+{
+    float m_x; ///< x-coordinate.
+    float m_y; ///< y-coordinate.
+    float m_r; ///< Radius.
+};
+
+/**
+ * @brief The EllipseValue struct holds the parameters of an ellipse.
+ */
+struct EllipseValue
+{
+    float m_x; ///< x-coordinate.
+    float m_y; ///< y-coordinate.
+    float m_rx; ///< x-radius.
+    float m_ry; ///< y-radius.
+};
+
+/**
+ * @brief The LineValue struct holds the parameters of a line.
+ */
+struct LineValue
+{
+    float m_x1; ///< First x-coordinate.
+    float m_y1; ///< First y-coordinate.
+    float m_x2; ///< Second x-coordinate.
+    float m_y2; ///< Second y-coordinate.
+};
+
+/**
+ * @brief The PolylineValuePoint struct is a point on a polyline value. Its members are named like std::pair so that code can be shared with the Polyline class.
+ */
+struct PolylineValuePoint
+{
+    float first; ///< x-coordinate.
+    float second; ///< y-coordinate.
+};
+
+/**
+ * @brief The PolylineValuePoints class is a fixed capacity array of polyline points with the parts of the std::vector interface that the shape algorithms use.
+ */
+class PolylineValuePoints
+{
+public:
+    static const std::uint32_t MAX_POINTS{16}; ///< The maximum number of points a polyline value can hold.
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void clear()
+    {
+        m_size = 0;
+    }
+
+    void push_back(const std::pair<float, float>& point)
+    {
+        assert(m_size < MAX_POINTS && "Polyline value has too many points");
+        if(m_size < MAX_POINTS) {
+            m_points[m_size++] = geometrize::PolylineValuePoint{point.first, point.second};
+        }
+    }
+
+    geometrize::PolylineValuePoint& operator[](const std::size_t i)
+    {
+        return m_points[i];
+    }
+
+    const geometrize::PolylineValuePoint& operator[](const std::size_t i) const
+    {
+        return m_points[i];
+    }
+
+    const geometrize::PolylineValuePoint* begin() const
+    {
+        return m_points;
+    }
+
+    const geometrize::PolylineValuePoint* end() const
+    {
+        return m_points + m_size;
+    }
+
+private:
+    geometrize::PolylineValuePoint m_points[MAX_POINTS]; ///< The points.
+    std::uint32_t m_size; ///< The number of points in use.
+};
+
+/**
+ * @brief The PolylineValue struct holds the parameters of a polyline.
+ */
+struct PolylineValue
+{
+    geometrize::PolylineValuePoints m_points; ///< The points on the polyline.
+};
+
+/**
+ * @brief The QuadraticBezierValue struct holds the parameters of a quadratic bezier curve.
+ */
+struct QuadraticBezierValue
+{
+    float m_cx; ///< Control point x-coordinate.
+    float m_cy; ///< Control point y-coordinate.
+    float m_x1; ///< First x-coordinate.
+    float m_y1; ///< First y-coordinate.
+    float m_x2; ///< Second x-coordinate.
+    float m_y2; ///< Second y-coordinate.
+};
+
+/**
+ * @brief The RectangleValue struct holds the parameters of a rectangle.
+ */
+struct RectangleValue
+{
+    float m_x1; ///< Left coordinate.
+    float m_y1; ///< Top coordinate.
+    float m_x2; ///< Right coordinate.
+    float m_y2; ///< Bottom coordinate.
+};
+
+/**
+ * @brief The RotatedEllipseValue struct holds the parameters of a rotated ellipse.
+ */
+struct RotatedEllipseValue
+{
+    float m_x; ///< x-coordinate.
+    float m_y; ///< y-coordinate.
+    float m_rx; ///< x-radius.
+    float m_ry; ///< y-radius.
+    float m_angle; ///< Rotation angle.
+};
+
+/**
+ * @brief The RotatedRectangleValue struct holds the parameters of a rotated rectangle.
+ */
+struct RotatedRectangleValue
+{
+    float m_x1; ///< Left coordinate.
+    float m_y1; ///< Top coordinate.
+    float m_x2; ///< Right coordinate.
+    float m_y2; ///< Bottom coordinate.
+    float m_angle; ///< Rotation angle.
+};
+
+/**
+ * @brief The TriangleValue struct holds the parameters of a triangle.
+ */
+struct TriangleValue
+{
+    float m_x1; ///< First x-coordinate.
+    float m_y1; ///< First y-coordinate.
+    float m_x2; ///< Second x-coordinate.
+    float m_y2; ///< Second y-coordinate.
+    float m_x3; ///< Third x-coordinate.
+    float m_y3; ///< Third y-coordinate.
+};
+
+/**
+ * @brief The ShapeValue struct is a trivially copyable tagged union of the shape value types.
+ */
+struct ShapeValue
+{
+    geometrize::ShapeTypes m_type; ///< The type of shape held, selects the member of the union that is in use.
+    union
+    {
+        geometrize::CircleValue m_circle;
+        geometrize::EllipseValue m_ellipse;
+        geometrize::LineValue m_line;
+        geometrize::PolylineValue m_polyline;
+        geometrize::QuadraticBezierValue m_quadraticBezier;
+        geometrize::RectangleValue m_rectangle;
+        geometrize::RotatedEllipseValue m_rotatedEllipse;
+        geometrize::RotatedRectangleValue m_rotatedRectangle;
+        geometrize::TriangleValue m_triangle;
+    };
+};
+
+/**
+ * @brief The ShapeValueTraits struct gives typed access to a shape value, letting code be written once for a single shape value type or for any shape value.
+ * Specialized for each shape value type, and for ShapeValue itself, where the whole tagged union is accessed.
+ */
+template<typename T> struct ShapeValueTraits;
+
+template<> struct ShapeValueTraits<geometrize::ShapeValue>
+{
+    static geometrize::ShapeValue& get(geometrize::ShapeValue& value)
+    {
+        return value;
+    }
+
+    static const geometrize::ShapeValue& get(const geometrize::ShapeValue& value)
+    {
+        return value;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::CircleValue>
+{
+    static geometrize::CircleValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::CIRCLE);
+        return value.m_circle;
+    }
+
+    static const geometrize::CircleValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::CIRCLE);
+        return value.m_circle;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::EllipseValue>
+{
+    static geometrize::EllipseValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::ELLIPSE);
+        return value.m_ellipse;
+    }
+
+    static const geometrize::EllipseValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::ELLIPSE);
+        return value.m_ellipse;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::LineValue>
+{
+    static geometrize::LineValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::LINE);
+        return value.m_line;
+    }
+
+    static const geometrize::LineValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::LINE);
+        return value.m_line;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::PolylineValue>
+{
+    static geometrize::PolylineValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::POLYLINE);
+        return value.m_polyline;
+    }
+
+    static const geometrize::PolylineValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::POLYLINE);
+        return value.m_polyline;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::QuadraticBezierValue>
+{
+    static geometrize::QuadraticBezierValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::QUADRATIC_BEZIER);
+        return value.m_quadraticBezier;
+    }
+
+    static const geometrize::QuadraticBezierValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::QUADRATIC_BEZIER);
+        return value.m_quadraticBezier;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::RectangleValue>
+{
+    static geometrize::RectangleValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::RECTANGLE);
+        return value.m_rectangle;
+    }
+
+    static const geometrize::RectangleValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::RECTANGLE);
+        return value.m_rectangle;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::RotatedEllipseValue>
+{
+    static geometrize::RotatedEllipseValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::ROTATED_ELLIPSE);
+        return value.m_rotatedEllipse;
+    }
+
+    static const geometrize::RotatedEllipseValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::ROTATED_ELLIPSE);
+        return value.m_rotatedEllipse;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::RotatedRectangleValue>
+{
+    static geometrize::RotatedRectangleValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::ROTATED_RECTANGLE);
+        return value.m_rotatedRectangle;
+    }
+
+    static const geometrize::RotatedRectangleValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::ROTATED_RECTANGLE);
+        return value.m_rotatedRectangle;
+    }
+};
+
+template<> struct ShapeValueTraits<geometrize::TriangleValue>
+{
+    static geometrize::TriangleValue& get(geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::TRIANGLE);
+        return value.m_triangle;
+    }
+
+    static const geometrize::TriangleValue& get(const geometrize::ShapeValue& value)
+    {
+        assert(value.m_type == geometrize::ShapeTypes::TRIANGLE);
+        return value.m_triangle;
+    }
+};
+
+/**
+ * @brief createShapeValue Creates a shape value of the given type, with all of its parameters zeroed.
+ * @param type The type of shape, must be a single shape type.
+ * @return The new shape value.
+ */
+geometrize::ShapeValue createShapeValue(geometrize::ShapeTypes type);
+
+/**
+ * @brief toShape Creates a shape from a shape value. The shape is given the default setup, mutate and rasterize functions for the given area.
+ * @param value The shape value.
+ * @param xMin The minimum x coordinate of the shape.
+ * @param yMin The minimum y coordinate of the shape.
+ * @param xMax The maximum x coordinate of the shape.
+ * @param yMax The maximum y coordinate of the shape.
+ * @return The new shape.
+ */
+std::shared_ptr<geometrize::Shape> toShape(const geometrize::ShapeValue& value, std::int32_t xMin, std::int32_t yMin, std::int32_t xMax, std::int32_t yMax);
+
+/**
+ * @brief assignShapeValue Copies the parameters held by a shape value into a shape of the same type. The functions of the shape are left untouched.
+ * Does not allocate memory unless a polyline needs more points than it has capacity for.
+ * @param shape The shape to write to.
+ * @param value The shape value.
+ */
+void assignShapeValue(geometrize::Shape& shape, const geometrize::ShapeValue& value);
+
+/**
+ * @brief fromShape Gets the shape value holding the parameters of the given shape.
+ * @param shape The shape.
+ * @param value The shape value to write to.
+ * @return True if the shape could be represented as a shape value, false if it could not (i.e. a polyline with more than PolylineValuePoints::MAX_POINTS points).
+ */
+bool fromShape(const geometrize::Shape& shape, geometrize::ShapeValue& value);
+
+}
@@ -18,9 +18,9 @@ namespace geometrize
  */
 struct ShapeResult
 {
-    const double score;
-    const geometrize::rgba color;
-    const std::shared_ptr<geometrize::Shape> shape;
+    double score;
+    geometrize::rgba color;
+    std::shared_ptr<geometrize::Shape> shape;
 };
 
 }
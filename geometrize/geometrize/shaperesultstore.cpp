@@ -0,0 +1,374 @@
+#include "shaperesultstore.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bitmap/rgba.h"
+#include "shape/circle.h"
+#include "shape/ellipse.h"
+#include "shape/line.h"
+#include "shape/polyline.h"
+#include "shape/quadraticbezier.h"
+#include "shape/rectangle.h"
+#include "shape/rotatedellipse.h"
+#include "shape/rotatedrectangle.h"
+#include "shape/shape.h"
+#include "shape/shapefactory.h"
+#include "shape/shapetypes.h"
+#include "shape/shapevalue.h"
+#include "shape/triangle.h"
+#include "shaperesult.h"
+
+namespace
+{
+
+const float ANGLE_QUANTIZATION_STEP{1.0f / 64.0f}; ///< The size of one quantization step for rotation angles, in degrees.
+
+/**
+ * @brief quantizeWithStep Rounds a value to the nearest multiple of a step, as a number of steps.
+ * @param value The value to quantize.
+ * @param step The size of one step.
+ * @return The number of steps. Throws std::out_of_range if it does not fit in 16 bits.
+ */
+std::int16_t quantizeWithStep(const float value, const float step)
+{
+    const float steps{std::round(value / step)};
+    if(!(steps >= INT16_MIN && steps <= INT16_MAX)) {
+        throw std::out_of_range("Shape parameter " + std::to_string(value) + " is out of range for a quantization step of " + std::to_string(step));
+    }
+    return static_cast<std::int16_t>(steps);
+}
+
+}
+
+namespace geometrize
+{
+
+PolylinePointsView::PolylinePointsView(const std::int16_t* coordinates, const std::size_t pointCount, const float quantizationStep) :
+    m_coordinates{coordinates}, m_pointCount{pointCount}, m_quantizationStep{quantizationStep}
+{
+}
+
+std::size_t PolylinePointsView::size() const
+{
+    return m_pointCount;
+}
+
+bool PolylinePointsView::empty() const
+{
+    return m_pointCount == 0;
+}
+
+geometrize::PolylineValuePoint PolylinePointsView::operator[](const std::size_t i) const
+{
+    assert(i < m_pointCount);
+    return geometrize::PolylineValuePoint{m_coordinates[i * 2U] * m_quantizationStep, m_coordinates[i * 2U + 1U] * m_quantizationStep};
+}
+
+ShapeResultStore::ShapeResultStore(const float quantizationStep) : m_quantizationStep{quantizationStep}
+{
+    assert(quantizationStep > 0.0f);
+}
+
+void ShapeResultStore::add(const geometrize::ShapeResult& result)
+{
+    const geometrize::Shape& shape{*result.shape};
+
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+    record.score = static_cast<float>(result.score);
+    record.color = result.color;
+    record.type = static_cast<std::uint16_t>(shape.getType());
+
+    std::int16_t* p{record.parameters};
+    switch(shape.getType()) {
+    case geometrize::ShapeTypes::RECTANGLE: {
+        const geometrize::Rectangle& s{static_cast<const geometrize::Rectangle&>(shape)};
+        p[0] = quantize(s.m_x1);
+        p[1] = quantize(s.m_y1);
+        p[2] = quantize(s.m_x2);
+        p[3] = quantize(s.m_y2);
+        break;
+    }
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE: {
+        const geometrize::RotatedRectangle& s{static_cast<const geometrize::RotatedRectangle&>(shape)};
+        p[0] = quantize(s.m_x1);
+        p[1] = quantize(s.m_y1);
+        p[2] = quantize(s.m_x2);
+        p[3] = quantize(s.m_y2);
+        p[4] = quantizeAngle(s.m_angle);
+        break;
+    }
+    case geometrize::ShapeTypes::TRIANGLE: {
+        const geometrize::Triangle& s{static_cast<const geometrize::Triangle&>(shape)};
+        p[0] = quantize(s.m_x1);
+        p[1] = quantize(s.m_y1);
+        p[2] = quantize(s.m_x2);
+        p[3] = quantize(s.m_y2);
+        p[4] = quantize(s.m_x3);
+        p[5] = quantize(s.m_y3);
+        break;
+    }
+    case geometrize::ShapeTypes::ELLIPSE: {
+        const geometrize::Ellipse& s{static_cast<const geometrize::Ellipse&>(shape)};
+        p[0] = quantize(s.m_x);
+        p[1] = quantize(s.m_y);
+        p[2] = quantize(s.m_rx);
+        p[3] = quantize(s.m_ry);
+        break;
+    }
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE: {
+        const geometrize::RotatedEllipse& s{static_cast<const geometrize::RotatedEllipse&>(shape)};
+        p[0] = quantize(s.m_x);
+        p[1] = quantize(s.m_y);
+        p[2] = quantize(s.m_rx);
+        p[3] = quantize(s.m_ry);
+        p[4] = quantizeAngle(s.m_angle);
+        break;
+    }
+    case geometrize::ShapeTypes::CIRCLE: {
+        const geometrize::Circle& s{static_cast<const geometrize::Circle&>(shape)};
+        p[0] = quantize(s.m_x);
+        p[1] = quantize(s.m_y);
+        p[2] = quantize(s.m_r);
+        break;
+    }
+    case geometrize::ShapeTypes::LINE: {
+        const geometrize::Line& s{static_cast<const geometrize::Line&>(shape)};
+        p[0] = quantize(s.m_x1);
+        p[1] = quantize(s.m_y1);
+        p[2] = quantize(s.m_x2);
+        p[3] = quantize(s.m_y2);
+        break;
+    }
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER: {
+        const geometrize::QuadraticBezier& s{static_cast<const geometrize::QuadraticBezier&>(shape)};
+        p[0] = quantize(s.m_cx);
+        p[1] = quantize(s.m_cy);
+        p[2] = quantize(s.m_x1);
+        p[3] = quantize(s.m_y1);
+        p[4] = quantize(s.m_x2);
+        p[5] = quantize(s.m_y2);
+        break;
+    }
+    case geometrize::ShapeTypes::POLYLINE: {
+        const geometrize::Polyline& s{static_cast<const geometrize::Polyline&>(shape)};
+        assert(s.m_points.size() <= UINT16_MAX && "Polyline has too many points to store");
+        assert(m_points.size() / 2U <= UINT32_MAX && "Too many polyline points to store");
+        const std::size_t pointsSize{m_points.size()};
+        const std::uint32_t offset{static_cast<std::uint32_t>(pointsSize / 2U)};
+        std::memcpy(p, &offset, sizeof(offset));
+        record.pointCount = static_cast<std::uint16_t>(s.m_points.size());
+        try {
+            for(std::size_t i = 0; i < record.pointCount; i++) {
+                m_points.push_back(quantize(s.m_points[i].first));
+                m_points.push_back(quantize(s.m_points[i].second));
+            }
+        } catch(...) {
+            m_points.resize(pointsSize); // Drop the points of the partly stored polyline
+            throw;
+        }
+        break;
+    }
+    default:
+        assert(0 && "Bad shape type");
+    }
+
+    m_records.push_back(record);
+}
+
+void ShapeResultStore::add(const std::vector<geometrize::ShapeResult>& results)
+{
+    m_records.reserve(m_records.size() + results.size());
+    for(const geometrize::ShapeResult& result : results) {
+        add(result);
+    }
+}
+
+void ShapeResultStore::reserve(const std::size_t count)
+{
+    m_records.reserve(count);
+}
+
+void ShapeResultStore::clear()
+{
+    m_records.clear();
+    m_points.clear();
+}
+
+std::size_t ShapeResultStore::size() const
+{
+    return m_records.size();
+}
+
+bool ShapeResultStore::empty() const
+{
+    return m_records.empty();
+}
+
+float ShapeResultStore::getQuantizationStep() const
+{
+    return m_quantizationStep;
+}
+
+geometrize::ShapeTypes ShapeResultStore::getType(const std::size_t index) const
+{
+    return static_cast<geometrize::ShapeTypes>(m_records[index].type);
+}
+
+geometrize::rgba ShapeResultStore::getColor(const std::size_t index) const
+{
+    return m_records[index].color;
+}
+
+float ShapeResultStore::getScore(const std::size_t index) const
+{
+    return m_records[index].score;
+}
+
+geometrize::CircleValue ShapeResultStore::getCircle(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::CIRCLE).parameters};
+    return geometrize::CircleValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2])};
+}
+
+geometrize::EllipseValue ShapeResultStore::getEllipse(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::ELLIPSE).parameters};
+    return geometrize::EllipseValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3])};
+}
+
+geometrize::LineValue ShapeResultStore::getLine(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::LINE).parameters};
+    return geometrize::LineValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3])};
+}
+
+geometrize::PolylineView ShapeResultStore::getPolyline(const std::size_t index) const
+{
+    const Record& record{getRecord(index, geometrize::ShapeTypes::POLYLINE)};
+    std::uint32_t offset{0};
+    std::memcpy(&offset, record.parameters, sizeof(offset));
+    return geometrize::PolylineView{geometrize::PolylinePointsView(m_points.data() + static_cast<std::size_t>(offset) * 2U, record.pointCount, m_quantizationStep)};
+}
+
+geometrize::QuadraticBezierValue ShapeResultStore::getQuadraticBezier(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::QUADRATIC_BEZIER).parameters};
+    return geometrize::QuadraticBezierValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3]), dequantize(p[4]), dequantize(p[5])};
+}
+
+geometrize::RectangleValue ShapeResultStore::getRectangle(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::RECTANGLE).parameters};
+    return geometrize::RectangleValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3])};
+}
+
+geometrize::RotatedEllipseValue ShapeResultStore::getRotatedEllipse(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::ROTATED_ELLIPSE).parameters};
+    return geometrize::RotatedEllipseValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3]), dequantizeAngle(p[4])};
+}
+
+geometrize::RotatedRectangleValue ShapeResultStore::getRotatedRectangle(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::ROTATED_RECTANGLE).parameters};
+    return geometrize::RotatedRectangleValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3]), dequantizeAngle(p[4])};
+}
+
+geometrize::TriangleValue ShapeResultStore::getTriangle(const std::size_t index) const
+{
+    const std::int16_t* p{getRecord(index, geometrize::ShapeTypes::TRIANGLE).parameters};
+    return geometrize::TriangleValue{dequantize(p[0]), dequantize(p[1]), dequantize(p[2]), dequantize(p[3]), dequantize(p[4]), dequantize(p[5])};
+}
+
+std::shared_ptr<geometrize::Shape> ShapeResultStore::createShape(const std::size_t index) const
+{
+    const geometrize::ShapeTypes type{getType(index)};
+    std::shared_ptr<geometrize::Shape> shape{geometrize::create(type)};
+
+    geometrize::ShapeValue value{geometrize::createShapeValue(type)};
+    switch(type) {
+    case geometrize::ShapeTypes::RECTANGLE:
+        value.m_rectangle = getRectangle(index);
+        break;
+    case geometrize::ShapeTypes::ROTATED_RECTANGLE:
+        value.m_rotatedRectangle = getRotatedRectangle(index);
+        break;
+    case geometrize::ShapeTypes::TRIANGLE:
+        value.m_triangle = getTriangle(index);
+        break;
+    case geometrize::ShapeTypes::ELLIPSE:
+        value.m_ellipse = getEllipse(index);
+        break;
+    case geometrize::ShapeTypes::ROTATED_ELLIPSE:
+        value.m_rotatedEllipse = getRotatedEllipse(index);
+        break;
+    case geometrize::ShapeTypes::CIRCLE:
+        value.m_circle = getCircle(index);
+        break;
+    case geometrize::ShapeTypes::LINE:
+        value.m_line = getLine(index);
+        break;
+    case geometrize::ShapeTypes::QUADRATIC_BEZIER:
+        value.m_quadraticBezier = getQuadraticBezier(index);
+        break;
+    case geometrize::ShapeTypes::POLYLINE: {
+        // Polylines may have more points than a shape value can hold, so are copied directly
+        const geometrize::PolylineView view{getPolyline(index)};
+        geometrize::Polyline& s{static_cast<geometrize::Polyline&>(*shape)};
+        s.m_points.reserve(view.m_points.size());
+        for(std::size_t i = 0; i < view.m_points.size(); i++) {
+            const geometrize::PolylineValuePoint point{view.m_points[i]};
+            s.m_points.push_back(std::make_pair(point.first, point.second));
+        }
+        return shape;
+    }
+    default:
+        assert(0 && "Bad shape type");
+        return shape;
+    }
+
+    geometrize::assignShapeValue(*shape, value);
+    return shape;
+}
+
+std::int16_t ShapeResultStore::quantize(const float value) const
+{
+    return quantizeWithStep(value, m_quantizationStep);
+}
+
+float ShapeResultStore::dequantize(const std::int16_t value) const
+{
+    return value * m_quantizationStep;
+}
+
+std::int16_t ShapeResultStore::quantizeAngle(const float angle) const
+{
+    return quantizeWithStep(angle, ANGLE_QUANTIZATION_STEP);
+}
+
+float ShapeResultStore::dequantizeAngle(const std::int16_t value) const
+{
+    return value * ANGLE_QUANTIZATION_STEP;
+}
+
+const ShapeResultStore::Record& ShapeResultStore::getRecord(const std::size_t index, const geometrize::ShapeTypes type) const
+{
+    const Record& record{m_records[index]};
+    assert(record.type == static_cast<std::uint16_t>(type) && "Shape result holds a different type of shape");
+    static_cast<void>(type);
+    return record;
+}
+
+static_assert(sizeof(geometrize::rgba) == 4, "Colors should be packed into four bytes");
+
+}
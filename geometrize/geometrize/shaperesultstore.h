@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bitmap/rgba.h"
+#include "shape/shapetypes.h"
+#include "shape/shapevalue.h"
+
+namespace geometrize
+{
+class Shape;
+struct ShapeResult;
+}
+
+namespace geometrize
+{
+
+/**
+ * @brief The PolylinePointsView class is a read-only view of the quantized points of a polyline held in a shape result store.
+ * It has the parts of the std::vector interface that the exporters use, so exporter code can be shared with the Polyline class.
+ */
+class PolylinePointsView
+{
+public:
+    PolylinePointsView(const std::int16_t* coordinates, std::size_t pointCount, float quantizationStep);
+
+    std::size_t size() const;
+    bool empty() const;
+    geometrize::PolylineValuePoint operator[](std::size_t i) const;
+
+private:
+    const std::int16_t* m_coordinates; ///< Interleaved x, y coordinates of the points.
+    std::size_t m_pointCount; ///< The number of points.
+    float m_quantizationStep; ///< The size of one quantization step.
+};
+
+/**
+ * @brief The PolylineView struct is a read-only view of a polyline held in a shape result store.
+ */
+struct PolylineView
+{
+    geometrize::PolylinePointsView m_points; ///< The points on the polyline.
+};
+
+/**
+ * @brief The ShapeResultStore class is a compact store for large numbers of shape results.
+ * Each result is held in a fixed size record of the shape type, its parameters quantized to 16-bit integers, its packed RGBA color and its score as a float.
+ * Polyline points are kept in a shared pool. No shape objects are kept, instead typed views of the shapes can be read back, which the exporters can use directly.
+ * Parameters are rounded to the nearest multiple of the quantization step, and must lie within 32767 steps of zero.
+ * Rotation angles have a fixed step of 1/64 of a degree instead, which holds angles up to 511 degrees either way.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class ShapeResultStore
+{
+public:
+    /**
+     * @brief ShapeResultStore Creates a new, empty shape result store.
+     * @param quantizationStep The size of one quantization step for shape parameters. With the default of a quarter pixel, coordinates up to 8191 pixels can be held, use a larger step for larger images.
+     */
+    explicit ShapeResultStore(float quantizationStep = 0.25f);
+
+    /**
+     * @brief add Adds a shape result to the end of the store.
+     * Throws std::out_of_range if a parameter of the shape is too large to store, in which case the store is left unchanged.
+     * @param result The shape result to add.
+     */
+    void add(const geometrize::ShapeResult& result);
+
+    /**
+     * @brief add Adds shape results to the end of the store.
+     * Throws std::out_of_range if a parameter of a shape is too large to store, in which case the results before that one are kept.
+     * @param results The shape results to add.
+     */
+    void add(const std::vector<geometrize::ShapeResult>& results);
+
+    /**
+     * @brief reserve Reserves space for the given number of shape results.
+     * @param count The number of shape results to reserve space for.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief clear Removes all of the shape results from the store.
+     */
+    void clear();
+
+    /**
+     * @brief size Gets the number of shape results in the store.
+     * @return The number of shape results.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief empty Returns true if the store holds no shape results.
+     * @return True if the store is empty, else false.
+     */
+    bool empty() const;
+
+    /**
+     * @brief getQuantizationStep Gets the size of one quantization step for shape parameters.
+     * @return The quantization step.
+     */
+    float getQuantizationStep() const;
+
+    /**
+     * @brief getType Gets the type of the shape in the given result.
+     * @param index The index of the result.
+     * @return The type of the shape.
+     */
+    geometrize::ShapeTypes getType(std::size_t index) const;
+
+    /**
+     * @brief getColor Gets the color of the shape in the given result.
+     * @param index The index of the result.
+     * @return The color of the shape.
+     */
+    geometrize::rgba getColor(std::size_t index) const;
+
+    /**
+     * @brief getScore Gets the score of the given result.
+     * @param index The index of the result.
+     * @return The score of the result.
+     */
+    float getScore(std::size_t index) const;
+
+    // Typed views of the shapes in the store, the shape in the result at the given index must be of the matching type
+    geometrize::CircleValue getCircle(std::size_t index) const;
+    geometrize::EllipseValue getEllipse(std::size_t index) const;
+    geometrize::LineValue getLine(std::size_t index) const;
+    geometrize::PolylineView getPolyline(std::size_t index) const;
+    geometrize::QuadraticBezierValue getQuadraticBezier(std::size_t index) const;
+    geometrize::RectangleValue getRectangle(std::size_t index) const;
+    geometrize::RotatedEllipseValue getRotatedEllipse(std::size_t index) const;
+    geometrize::RotatedRectangleValue getRotatedRectangle(std::size_t index) const;
+    geometrize::TriangleValue getTriangle(std::size_t index) const;
+
+    /**
+     * @brief createShape Creates a shape object holding the (quantized) parameters of the shape in the given result.
+     * The shape is not given setup, mutate or rasterize functions.
+     * @param index The index of the result.
+     * @return The new shape.
+     */
+    std::shared_ptr<geometrize::Shape> createShape(std::size_t index) const;
+
+private:
+    /**
+     * @brief The Record struct is the fixed size record kept for each shape result.
+     */
+    struct Record
+    {
+        float score; ///< The score of the result.
+        geometrize::rgba color; ///< The color of the shape.
+        std::uint16_t type; ///< The type of the shape.
+        std::uint16_t pointCount; ///< The number of points of a polyline.
+        std::int16_t parameters[6]; ///< The quantized shape parameters, or for polylines the offset of the first point in the point pool.
+    };
+
+    std::int16_t quantize(float value) const;
+    float dequantize(std::int16_t value) const;
+    std::int16_t quantizeAngle(float angle) const;
+    float dequantizeAngle(std::int16_t value) const;
+    const Record& getRecord(std::size_t index, geometrize::ShapeTypes type) const;
+
+    float m_quantizationStep; ///< The size of one quantization step for shape parameters.
+    std::vector<Record> m_records; ///< The records of the shape results.
+    std::vector<std::int16_t> m_points; ///< Quantized, interleaved x, y coordinates of the points of all polylines in the store.
+};
+
+}
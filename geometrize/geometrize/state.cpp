@@ -2,16 +2,20 @@
 
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "rasterizer/scanline.h"
 #include "shape/shape.h"
+#include "shape/shapevalue.h"
 
 namespace geometrize
 {
 
-State::State() : m_score{-1.0}, m_alpha{0}, m_shape{nullptr} {}
+State::State() : m_score{-1.0}, m_alpha{0}, m_shape{nullptr}, m_color{0, 0, 0, 0}, m_hasLines{false}, m_hasColor{false} {}
 
 State::State(const std::shared_ptr<geometrize::Shape>& shape, const std::uint8_t alpha) :
-    m_score{-1.0}, m_alpha{alpha}, m_shape{shape}
+    m_score{-1.0}, m_alpha{alpha}, m_shape{shape}, m_color{0, 0, 0, 0}, m_hasLines{false}, m_hasColor{false}
 {
     m_shape->setup(*m_shape);
 }
@@ -22,20 +26,65 @@ State& State::operator=(const geometrize::State& other)
         m_score = other.m_score;
         m_alpha = other.m_alpha;
         m_shape = other.m_shape->clone();
+        m_lines = other.m_lines;
+        m_color = other.m_color;
+        m_hasLines = other.m_hasLines;
+        m_hasColor = other.m_hasColor;
     }
     return *this;
 }
 
-State::State(const geometrize::State& other) : m_score{other.m_score}, m_alpha{other.m_alpha}, m_shape{other.m_shape->clone()}
+State::State(const geometrize::State& other) :
+    m_score{other.m_score}, m_alpha{other.m_alpha}, m_shape{other.m_shape->clone()},
+    m_lines{other.m_lines}, m_color{other.m_color}, m_hasLines{other.m_hasLines}, m_hasColor{other.m_hasColor}
 {
 }
 
-geometrize::State State::mutate()
+State::State(geometrize::State&& other) noexcept = default;
+
+State& State::operator=(geometrize::State&& other) noexcept = default;
+
+geometrize::StateUndo State::mutate()
 {
-    geometrize::State oldState(*this);
+    geometrize::StateUndo undo;
+    undo.m_score = m_score;
+    if(!geometrize::fromShape(*m_shape, undo.m_shape)) {
+        undo.m_shapeClone = m_shape->clone();
+    }
+    undo.m_lines = std::move(m_lines);
+    undo.m_color = m_color;
+    undo.m_hasLines = m_hasLines;
+    undo.m_hasColor = m_hasColor;
+
     m_shape->mutate(*m_shape);
     m_score = -1;
-    return oldState;
+    m_lines.clear();
+    m_hasLines = false;
+    m_hasColor = false;
+    return undo;
+}
+
+void State::revert(geometrize::StateUndo& undo)
+{
+    if(undo.m_shapeClone) {
+        m_shape = undo.m_shapeClone;
+    } else {
+        geometrize::assignShapeValue(*m_shape, undo.m_shape);
+    }
+    m_score = undo.m_score;
+    m_lines = std::move(undo.m_lines);
+    m_color = undo.m_color;
+    m_hasLines = undo.m_hasLines;
+    m_hasColor = undo.m_hasColor;
+}
+
+const std::vector<geometrize::Scanline>& State::rasterize()
+{
+    if(!m_hasLines) {
+        m_lines = m_shape->rasterize(*m_shape);
+        m_hasLines = true;
+    }
+    return m_lines;
 }
 
 }
@@ -2,6 +2,11 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
+
+#include "bitmap/rgba.h"
+#include "rasterizer/scanline.h"
+#include "shape/shapevalue.h"
 
 namespace geometrize
 {
@@ -13,6 +18,21 @@ class Shape;
 namespace geometrize
 {
 
+/**
+ * @brief The StateUndo struct records the parts of a state that are changed by mutating it, so that the mutation can be reverted without cloning the shape.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+struct StateUndo
+{
+    double m_score; ///< The score of the state before the mutation.
+    geometrize::ShapeValue m_shape; ///< The parameters of the shape before the mutation, used unless m_shapeClone is set.
+    std::shared_ptr<geometrize::Shape> m_shapeClone; ///< A copy of the shape before the mutation, only made for shapes that cannot be held as a shape value.
+    std::vector<geometrize::Scanline> m_lines; ///< The scanlines cached for the shape before the mutation.
+    geometrize::rgba m_color; ///< The color cached for the shape before the mutation.
+    bool m_hasLines; ///< Whether m_lines is valid.
+    bool m_hasColor; ///< Whether m_color is valid.
+};
+
 /**
  * @brief The State class relates a shape and related properties to a measure of how close it brings the working image to the target image.
  * @author Sam Twidale (https://samcodes.co.uk/)
@@ -31,16 +51,36 @@ public:
     ~State() = default;
     State(const State& other);
     State& operator=(const State& other);
+    State(State&& other) noexcept;
+    State& operator=(State&& other) noexcept;
 
     /**
      * @brief mutate Modifies the current state in a random fashion.
-     * @return The old state, useful for undoing the mutation or keeping track of previous states.
+     * Only the shape parameters are recorded before mutating the shape in place, and any scanlines and color cached for the shape are moved into the record,
+     * so a rejected mutation can be reverted without allocating memory or rasterizing the shape again.
+     * @return A record of the state before the mutation, to pass to revert to undo the mutation.
+     */
+    geometrize::StateUndo mutate();
+
+    /**
+     * @brief revert Undoes a mutation, restoring the state to how it was before the mutate call that returned the given record.
+     * @param undo The record returned by the last call to mutate. Its cached scanlines are moved back into the state.
+     */
+    void revert(geometrize::StateUndo& undo);
+
+    /**
+     * @brief rasterize Gets the scanlines of the shape, rasterizing it only if they are not already cached in the state.
+     * @return The scanlines of the shape.
      */
-    geometrize::State mutate();
+    const std::vector<geometrize::Scanline>& rasterize();
 
     double m_score; ///< The score of the state, a measure of the improvement applying the state to the current bitmap will have.
     std::uint8_t m_alpha; ///< The alpha of the shape.
     std::shared_ptr<geometrize::Shape> m_shape; ///< The geometric primitive owned by the state.
+    std::vector<geometrize::Scanline> m_lines; ///< The scanlines of the shape, only valid if m_hasLines is set.
+    geometrize::rgba m_color; ///< The color calculated for the scanlines of the shape, only valid if m_hasColor is set.
+    bool m_hasLines; ///< Whether the scanlines of the shape are cached in m_lines.
+    bool m_hasColor; ///< Whether the color for the scanlines of the shape is cached in m_color.
 };
 
 }
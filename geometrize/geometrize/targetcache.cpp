@@ -0,0 +1,107 @@
+#include "targetcache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "bitmap/bitmap.h"
+#include "bitmap/bitmappyramid.h"
+#include "bitmap/planarbitmap.h"
+#include "bitmap/rgba.h"
+#include "commonutil.h"
+
+namespace
+{
+
+std::mutex cachesMutex; ///< Guards the caches map.
+
+/// The caches of the targets that have them, by target. Entries are removed once either the target or the cache expires.
+std::map<std::weak_ptr<const geometrize::Bitmap>, std::weak_ptr<geometrize::TargetCache>, std::owner_less<std::weak_ptr<const geometrize::Bitmap>>> caches;
+
+}
+
+namespace geometrize
+{
+
+std::shared_ptr<geometrize::TargetCache> TargetCache::get(const std::shared_ptr<const geometrize::Bitmap>& target)
+{
+    const std::lock_guard<std::mutex> lock(cachesMutex);
+
+    for(auto it = caches.begin(); it != caches.end();) {
+        it = (it->first.expired() || it->second.expired()) ? caches.erase(it) : std::next(it);
+    }
+
+    std::weak_ptr<geometrize::TargetCache>& entry{caches[target]};
+    std::shared_ptr<geometrize::TargetCache> cache{entry.lock()};
+    if(!cache) {
+        cache = std::make_shared<geometrize::TargetCache>(target);
+        entry = cache;
+    }
+    return cache;
+}
+
+TargetCache::TargetCache(std::shared_ptr<const geometrize::Bitmap> target) : m_target{std::move(target)}
+{
+}
+
+geometrize::rgba TargetCache::getAverageColor()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_hasAverageColor) {
+        m_averageColor = geometrize::commonutil::getAverageImageColor(*m_target);
+        m_hasAverageColor = true;
+    }
+    return m_averageColor;
+}
+
+std::shared_ptr<const geometrize::Bitmap> TargetCache::getDownsampled(const std::uint32_t factor)
+{
+    std::uint32_t levelCount{0U};
+    while((1U << levelCount) < factor) {
+        levelCount++;
+    }
+    assert((1U << levelCount) == factor && "The target can only be shrunk by a power of two");
+    if(levelCount == 0U) {
+        return m_target;
+    }
+
+    // A pyramid made with more levels than needed is kept, earlier levels are the same either way
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_pyramid || m_pyramidLevelCount < levelCount) {
+        m_pyramid = std::make_shared<const geometrize::BitmapPyramid>(*m_target, levelCount);
+        m_pyramidLevelCount = levelCount;
+    }
+    if(m_pyramid->getLevelCount() == 0U) {
+        return m_target; // Already 1x1 pixels or less
+    }
+
+    // The shrunk copy shares ownership of the pyramid it is part of, the pyramid stops early once a level is 1x1 pixels
+    return std::shared_ptr<const geometrize::Bitmap>(m_pyramid, &m_pyramid->getLevel((std::min)(static_cast<std::size_t>(levelCount), m_pyramid->getLevelCount())));
+}
+
+bool TargetCache::isOpaque()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_hasOpacity) {
+        m_opaque = geometrize::PlanarBitmap::isOpaque(*m_target);
+        m_hasOpacity = true;
+    }
+    return m_opaque;
+}
+
+std::shared_ptr<const geometrize::PlanarBitmap> TargetCache::getPlanar(const bool keepAlpha)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    std::shared_ptr<const geometrize::PlanarBitmap>& planar{m_planar[keepAlpha ? 1 : 0]};
+    if(!planar) {
+        planar = std::make_shared<const geometrize::PlanarBitmap>(*m_target, keepAlpha);
+    }
+    return planar;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "bitmap/rgba.h"
+
+namespace geometrize
+{
+class Bitmap;
+class BitmapPyramid;
+class PlanarBitmap;
+}
+
+namespace geometrize
+{
+
+/**
+ * @brief The TargetCache class holds data derived from a target bitmap, such as its average color, shrunk and planar copies of it, so that every model and
+ * image runner sharing the target computes the data only once. There is one cache per target, looked up by the shared pointer to the target,
+ * and the cache lives for as long as something holds a pointer to it. The target must not be changed while it has a cache. The cache is thread-safe.
+ * @author Sam Twidale (https://samcodes.co.uk/)
+ */
+class TargetCache
+{
+public:
+    /**
+     * @brief get Gets the cache for the given target, creating it if the target has no cache yet.
+     * @param target The target bitmap.
+     * @return The cache for the target.
+     */
+    static std::shared_ptr<geometrize::TargetCache> get(const std::shared_ptr<const geometrize::Bitmap>& target);
+
+    explicit TargetCache(std::shared_ptr<const geometrize::Bitmap> target);
+    ~TargetCache() = default;
+    TargetCache& operator=(const TargetCache&) = delete;
+    TargetCache(const TargetCache&) = delete;
+
+    /**
+     * @brief getAverageColor Gets the average RGB color of the target, computing it on first use.
+     * @return The average color of the target, alpha is set to opaque (255).
+     */
+    geometrize::rgba getAverageColor();
+
+    /**
+     * @brief getDownsampled Gets a copy of the target shrunk by the given factor, taken from a pyramid of halved copies of the target that is computed on first use.
+     * @param factor The factor to shrink the target by in each dimension, which must be a power of two.
+     * @return The shrunk target, which is the target itself for a factor of 1.
+     */
+    std::shared_ptr<const geometrize::Bitmap> getDownsampled(std::uint32_t factor);
+
+    /**
+     * @brief isOpaque Returns true if every pixel of the target has an alpha of 255, checking on first use.
+     * @return True if the target is fully opaque, else false.
+     */
+    bool isOpaque();
+
+    /**
+     * @brief getPlanar Gets a planar copy of the target for scoring, computing it on first use.
+     * @param keepAlpha Whether the copy keeps the alpha plane. If false, the target must be fully opaque.
+     * @return The planar copy of the target.
+     */
+    std::shared_ptr<const geometrize::PlanarBitmap> getPlanar(bool keepAlpha);
+
+private:
+    const std::shared_ptr<const geometrize::Bitmap> m_target; ///< The target bitmap the data is derived from.
+    std::mutex m_mutex; ///< Guards the derived data.
+    bool m_hasAverageColor{false}; ///< Whether the average color has been computed yet.
+    geometrize::rgba m_averageColor{0, 0, 0, 0}; ///< The average color of the target.
+    std::shared_ptr<const geometrize::BitmapPyramid> m_pyramid; ///< Successively halved copies of the target, or null if none were needed yet.
+    std::uint32_t m_pyramidLevelCount{0U}; ///< The number of levels asked for when the pyramid was made.
+    bool m_hasOpacity{false}; ///< Whether the target has been checked for transparent pixels yet.
+    bool m_opaque{false}; ///< Whether every pixel of the target is opaque.
+    std::shared_ptr<const geometrize::PlanarBitmap> m_planar[2]; ///< Planar copies of the target, without and with the alpha plane.
+};
+
+}